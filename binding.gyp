@@ -7,12 +7,20 @@
       'target_name': 'binding',
       'win_delay_load_hook': 'true',
       'sources': [
+        'src/addon_data.cpp',
+        'src/batch_compiler.cpp',
         'src/binding.cpp',
+        'src/call_dispatcher.cpp',
+        'src/compile_pool.cpp',
+        'src/compiler.cpp',
         'src/create_string.cpp',
         'src/custom_function_bridge.cpp',
         'src/custom_importer_bridge.cpp',
+        'src/output_sink.cpp',
         'src/sass_context_wrapper.cpp',
+        'src/take_buffer.cpp',
         'src/sass_types/boolean.cpp',
+        'src/sass_types/child_cache.cpp',
         'src/sass_types/color.cpp',
         'src/sass_types/error.cpp',
         'src/sass_types/factory.cpp',
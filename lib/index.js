@@ -3,6 +3,7 @@
  */
 
 var path = require('path'),
+  os = require('os'),
   clonedeep = require('lodash/cloneDeep'),
   assign = require('lodash/assign'),
   sass = require('./extensions');
@@ -58,6 +59,28 @@ function getSourceMap(options) {
   return sourceMap && typeof sourceMap === 'string' ? path.resolve(sourceMap) : null;
 }
 
+/**
+ * Get output
+ *
+ * Writes the chunks of the css to `options.outputStream`
+ * while it is generated.
+ *
+ * @param {Object} options
+ * @api private
+ */
+
+function getOutput(options) {
+  var stream = options.outputStream;
+
+  if (!stream || typeof stream.write !== 'function') {
+    return null;
+  }
+
+  return function(chunk) {
+    stream.write(chunk);
+  };
+}
+
 /**
  * Get stats
  *
@@ -190,7 +213,8 @@ function getOptions(opts, cb) {
   if (typeof opts !== 'object') {
     throw new Error('Invalid: options is not an object.');
   }
-  var options = clonedeep(opts || {});
+  // the stream is not cloned
+  var options = clonedeep(assign({}, opts, { outputStream: null }));
 
   options.sourceComments = options.sourceComments || false;
   if (options.hasOwnProperty('file')) {
@@ -204,6 +228,13 @@ function getOptions(opts, cb) {
   options.indentWidth = getIndentWidth(options);
   options.indentType = getIndentType(options);
   options.linefeed = getLinefeed(options);
+  options.sheetCache = options.sheetCache || false;
+  options.fileCache = options.fileCache || false;
+  options.functionCache = options.functionCache || false;
+  options.importThreads = parseInt(options.importThreads) || 0;
+  options.mmapSources = options.mmapSources || false;
+  options.timeout = Math.max(parseInt(options.timeout) || 0, 0);
+  options.output = getOutput(opts || {});
 
   // context object represents node-sass environment
   options.context = { options: options, callback: cb };
@@ -276,6 +307,133 @@ function normalizeFunctionSignature(signature, callback) {
   };
 }
 
+/**
+ * Wraps importers for asynchronous renders, the bridge
+ * resumes the compilation with the result
+ *
+ * @param {Function|Array} importer
+ * @param {Object} context
+ * @return {Function|Array}
+ * @api private
+ */
+
+function wrapImporter(importer, context) {
+  if (!importer) {
+    return importer;
+  }
+
+  function wrap(subject) {
+    return function(file, prev, bridge) {
+      function done(result) {
+        bridge.success(result === module.exports.NULL ? null : result);
+      }
+
+      var result = subject.call(context, file, prev, done);
+
+      if (result !== undefined) {
+        done(result);
+      }
+    };
+  }
+
+  return Array.isArray(importer) ? importer.map(wrap) : wrap(importer);
+}
+
+/**
+ * Wraps importers for synchronous renders
+ *
+ * @param {Function|Array} importer
+ * @param {Object} context
+ * @return {Function|Array}
+ * @api private
+ */
+
+function wrapImporterSync(importer, context) {
+  if (!importer) {
+    return importer;
+  }
+
+  function wrap(subject) {
+    return function(file, prev) {
+      var result = subject.call(context, file, prev);
+
+      return result === module.exports.NULL ? null : result;
+    };
+  }
+
+  return Array.isArray(importer) ? importer.map(wrap) : wrap(importer);
+}
+
+/**
+ * Wraps custom functions for asynchronous renders, keyed
+ * by their normalized signatures
+ *
+ * @param {Object} functions
+ * @param {Object} context
+ * @return {Object}
+ * @api private
+ */
+
+function wrapFunctions(functions, context) {
+  if (!functions) {
+    return functions;
+  }
+
+  var wrapped = {};
+
+  functions = clonedeep(functions);
+  Object.keys(functions).forEach(function(subject) {
+    var cb = normalizeFunctionSignature(subject, functions[subject]);
+
+    wrapped[cb.signature] = function() {
+      var args = Array.prototype.slice.call(arguments),
+        bridge = args.pop();
+
+      function done(data) {
+        bridge.success(data);
+      }
+
+      var result = tryCallback(cb.callback.bind(context), args.concat(done));
+
+      if (result) {
+        done(result);
+      }
+    };
+    wrapped[cb.signature].pure = !!functions[subject].pure;
+  });
+
+  return wrapped;
+}
+
+/**
+ * Wraps custom functions for synchronous renders
+ *
+ * @param {Object} functions
+ * @param {Object} context
+ * @return {Object}
+ * @api private
+ */
+
+function wrapFunctionsSync(functions, context) {
+  if (!functions) {
+    return functions;
+  }
+
+  var wrapped = {};
+
+  functions = clonedeep(functions);
+  Object.keys(functions).forEach(function(signature) {
+    var cb = normalizeFunctionSignature(signature, functions[signature]);
+
+    wrapped[cb.signature] = function() {
+      return tryCallback(cb.callback.bind(context), arguments);
+    };
+    wrapped[cb.signature].pure = !!functions[signature].pure;
+  });
+
+  return wrapped;
+}
+
 /**
  * Render
  *
@@ -311,134 +469,347 @@ module.exports.render = function(opts, cb) {
     }
   };
 
-  var importer = options.importer;
+  options.importer = wrapImporter(options.importer, options.context);
+  options.functions = wrapFunctions(options.functions, options.context);
 
-  if (importer) {
-    if (Array.isArray(importer)) {
-      options.importer = [];
-      importer.forEach(function(subject, index) {
-        options.importer[index] = function(file, prev, bridge) {
-          function done(result) {
-            bridge.success(result === module.exports.NULL ? null : result);
-          }
-
-          var result = subject.call(options.context, file, prev, done);
+  if (options.data) {
+    binding.render(options);
+  } else if (options.file) {
+    binding.renderFile(options);
+  } else {
+    cb({status: 3, message: 'No input specified: provide a file name or a source string to process' });
+  }
+};
 
-          if (result !== undefined) {
-            done(result);
-          }
-        };
-      });
-    } else {
-      options.importer = function(file, prev, bridge) {
-        function done(result) {
-          bridge.success(result === module.exports.NULL ? null : result);
-        }
+/**
+ * Render sync
+ *
+ * @param {Object} options
+ * @api public
+ */
 
-        var result = importer.call(options.context, file, prev, done);
+module.exports.renderSync = function(opts) {
+  var options = getOptions(opts);
+  options.importer = wrapImporterSync(options.importer, options.context);
+  options.functions = wrapFunctionsSync(options.functions, options.context);
 
-        if (result !== undefined) {
-          done(result);
-        }
-      };
-    }
+  var status;
+  if (options.data) {
+    status = binding.renderSync(options);
+  } else if (options.file) {
+    status = binding.renderFileSync(options);
+  } else {
+    throw new Error('No input specified: provide a file name or a source string to process');
   }
 
-  var functions = clonedeep(options.functions);
+  var result = options.result;
 
-  if (functions) {
-    options.functions = {};
+  if (status) {
+    result.stats = endStats(result.stats);
+    return result;
+  }
 
-    Object.keys(functions).forEach(function(subject) {
-      var cb = normalizeFunctionSignature(subject, functions[subject]);
+  throw assign(new Error(), JSON.parse(result.error));
+};
 
-      options.functions[cb.signature] = function() {
-        var args = Array.prototype.slice.call(arguments),
-          bridge = args.pop();
+/**
+ * Get compiler input
+ *
+ * @param {Object} input
+ * @api private
+ */
 
-        function done(data) {
-          bridge.success(data);
-        }
+function getCompilerInput(input) {
+  if (typeof input !== 'object' || input === null) {
+    throw new Error('Invalid: input is not an object.');
+  }
 
-        var result = tryCallback(cb.callback.bind(options.context), args.concat(done));
+  var subject = {
+    data: typeof input.data === 'string' ? input.data : null,
+    file: getInputFile(input),
+    output: getOutput(input)
+  };
 
-        if (result) {
-          done(result);
-        }
-      };
-    });
+  if (subject.data === null && !subject.file) {
+    throw new Error('No input specified: provide a file name or a source string to process');
   }
 
-  if (options.data) {
-    binding.render(options);
-  } else if (options.file) {
-    binding.renderFile(options);
-  } else {
-    cb({status: 3, message: 'No input specified: provide a file name or a source string to process' });
-  }
-};
+  subject.result = {
+    stats: getStats(subject)
+  };
+
+  return subject;
+}
 
 /**
- * Render sync
+ * Create compiler
+ *
+ * Extracts the options once for many renders where only the
+ * input changes. Returns an object with `render(input, cb)` and
+ * `renderSync(input)`, `input` being `{ data }` or `{ file }`.
  *
  * @param {Object} options
+ * @return {Object}
  * @api public
  */
 
-module.exports.renderSync = function(opts) {
-  var options = getOptions(opts);
-  var importer = options.importer;
+module.exports.createCompiler = function(opts) {
+  var options = getOptions(assign({}, opts, { data: null, file: null }));
+
+  // output paths do not depend on the input of a render
+  options.outFile = getOutputFile(assign({}, opts, { data: true }));
+  options.sourceMap = getSourceMap(assign({}, opts, { outFile: options.outFile }));
+
+  // each render picks the wrappers of its mode
+  options.importerSync = wrapImporterSync(options.importer, options.context);
+  options.importer = wrapImporter(options.importer, options.context);
+  options.functionsSync = wrapFunctionsSync(options.functions, options.context);
+  options.functions = wrapFunctions(options.functions, options.context);
+  if (typeof options.importer === 'function') {
+    options.importer = [options.importer];
+    options.importerSync = [options.importerSync];
+  }
+
+  var handle = binding.createCompiler(options);
+
+  return {
+    render: function(input, cb) {
+      var subject = getCompilerInput(input);
+
+      subject.error = function(err) {
+        var payload = assign(new Error(), JSON.parse(err));
 
-  if (importer) {
-    if (Array.isArray(importer)) {
-      options.importer = [];
-      importer.forEach(function(subject, index) {
-        options.importer[index] = function(file, prev) {
-          var result = subject.call(options.context, file, prev);
+        if (cb) {
+          cb.call(options.context, payload, null);
+        }
+      };
 
-          return result === module.exports.NULL ? null : result;
+      subject.success = function() {
+        var result = subject.result;
+        var payload = {
+          css: result.css,
+          stats: endStats(result.stats)
         };
-      });
-    } else {
-      options.importer = function(file, prev) {
-        var result = importer.call(options.context, file, prev);
+        if (result.map) {
+          payload.map = result.map;
+        }
 
-        return result === module.exports.NULL ? null : result;
+        if (cb) {
+          cb.call(options.context, null, payload);
+        }
       };
+
+      binding.compilerRender(handle, subject);
+    },
+
+    renderSync: function(input) {
+      var subject = getCompilerInput(input);
+      var result = subject.result;
+
+      if (binding.compilerRenderSync(handle, subject)) {
+        result.stats = endStats(result.stats);
+        return result;
+      }
+
+      throw assign(new Error(), JSON.parse(result.error));
     }
+  };
+};
+
+/**
+ * Get batch entry
+ *
+ * @param {Object} options
+ * @param {String|Object} entry
+ * @api private
+ */
+
+function getBatchEntry(options, entry) {
+  var subject = typeof entry === 'string' ? { file: entry } : assign({}, entry);
+
+  if (!subject.file || typeof subject.file !== 'string') {
+    throw new Error('Invalid: batch entry has no file.');
+  }
+  if (!subject.hasOwnProperty('sourceMap')) {
+    subject.sourceMap = options.sourceMap;
   }
 
-  var functions = clonedeep(options.functions);
+  subject.file = getInputFile(subject);
+  subject.outFile = getOutputFile(subject);
+  subject.sourceMap = getSourceMap(subject);
 
-  if (options.functions) {
-    options.functions = {};
+  return subject;
+}
 
-    Object.keys(functions).forEach(function(signature) {
-      var cb = normalizeFunctionSignature(signature, functions[signature]);
+/**
+ * Render batch
+ *
+ * Compiles many entry files with the same options on a native
+ * worker pool. `options.onResult` is called as soon as an entry
+ * is done, the callback receives the results in input order.
+ *
+ * @param {Object} options
+ * @param {Function} cb
+ * @api public
+ */
 
-      options.functions[cb.signature] = function() {
-        return tryCallback(cb.callback.bind(options.context), arguments);
-      };
-    });
+module.exports.renderBatch = function(opts, cb) {
+  if (typeof opts !== 'object' || !Array.isArray(opts.files)) {
+    throw new Error('Invalid: options.files is not an array.');
   }
 
-  var status;
-  if (options.data) {
-    status = binding.renderSync(options);
-  } else if (options.file) {
-    status = binding.renderFileSync(options);
+  var files = opts.files;
+  var options = getOptions(assign({}, opts, { files: null, data: null, file: null }), cb);
+  var results = new Array(files.length);
+  var start = Date.now();
+
+  // per entry settings, everything else is shared
+  options.entries = files.map(function(entry) {
+    return getBatchEntry(opts, entry);
+  });
+  options.concurrency = parseInt(options.concurrency) || os.cpus().length;
+  options.importer = wrapImporter(options.importer, options.context);
+  options.functions = wrapFunctions(options.functions, options.context);
+
+  options.result = function(index, result) {
+    var entry = options.entries[index];
+    var payload;
+
+    if (result.error) {
+      payload = assign(new Error(), JSON.parse(result.error));
+    } else {
+      payload = {
+        css: result.css,
+        stats: endStats({
+          entry: entry.file,
+          start: start,
+          includedFiles: result.includedFiles
+        })
+      };
+      if (result.map) {
+        payload.map = result.map;
+      }
+    }
+
+    results[index] = payload;
+
+    if (typeof opts.onResult === 'function') {
+      opts.onResult.call(options.context, result.error ? payload : null, result.error ? null : payload, entry.file);
+    }
+  };
+
+  options.done = function() {
+    if (cb) {
+      options.context.callback.call(options.context, null, results);
+    }
+  };
+
+  binding.renderBatch(options);
+};
+
+/**
+ * Drop parsed stylesheets from the shared cache
+ *
+ * @param {String} file (all files if omitted)
+ * @api public
+ */
+
+module.exports.invalidateSheetCache = function(file) {
+  if (typeof file === 'string') {
+    binding.invalidateSheetCache(path.resolve(file));
   } else {
-    throw new Error('No input specified: provide a file name or a source string to process');
+    binding.invalidateSheetCache();
   }
+};
 
-  var result = options.result;
+/**
+ * Report a changed, added or removed file
+ *
+ * Drops the file from the shared cache and returns all entry
+ * files rendered with `sheetCache` that need to be rendered again.
+ *
+ * @param {String} file
+ * @api public
+ */
 
-  if (status) {
-    result.stats = endStats(result.stats);
-    return result;
+module.exports.fileChanged = function(file) {
+  return binding.fileChanged(path.resolve(file));
+};
+
+/**
+ * Files imported by the given file, as seen by the last render
+ *
+ * @param {String} file
+ * @api public
+ */
+
+module.exports.getDependencies = function(file) {
+  return binding.getDependencies(path.resolve(file));
+};
+
+/**
+ * Shared stylesheet cache statistics
+ *
+ * @api public
+ */
+
+module.exports.sheetCacheStats = function() {
+  return binding.sheetCacheStats();
+};
+
+/**
+ * Drop cached directory listings
+ *
+ * @param {String} file (all directories if omitted)
+ * @api public
+ */
+
+module.exports.invalidateFileCache = function(file) {
+  if (typeof file === 'string') {
+    binding.invalidateFileCache(path.resolve(file));
+  } else {
+    binding.invalidateFileCache();
   }
+};
 
-  throw assign(new Error(), JSON.parse(result.error));
+/**
+ * Shared directory listing cache statistics
+ *
+ * @api public
+ */
+
+module.exports.fileCacheStats = function() {
+  return binding.fileCacheStats();
+};
+
+/**
+ * Drop cached results of pure custom functions
+ *
+ * @api public
+ */
+
+module.exports.clearFunctionCache = function() {
+  binding.clearFunctionCache();
+};
+
+/**
+ * Shared pure function result cache statistics
+ *
+ * @api public
+ */
+
+module.exports.functionCacheStats = function() {
+  return binding.functionCacheStats();
+};
+
+/**
+ * Statistics of asynchronous custom function and importer calls
+ *
+ * @api public
+ */
+
+module.exports.callbackStats = function() {
+  return binding.callbackStats();
 };
 
 /**
@@ -33,7 +33,8 @@ module.exports = function(options, emitter) {
     functions: options.functions,
     indentWidth: options.indentWidth,
     indentType: options.indentType,
-    linefeed: options.linefeed
+    linefeed: options.linefeed,
+    sheetCache: options.sheetCache
   };
 
   if (options.data) {
@@ -113,6 +114,9 @@ module.exports = function(options, emitter) {
       error(err);
     }
     else {
+      if (renderOptions.file) {
+        emitter.emit('compiled', path.resolve(renderOptions.file));
+      }
       success(result);
     }
   };
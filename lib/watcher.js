@@ -3,15 +3,20 @@ var grapher = require('sass-graph'),
   path = require('path'),
   config = {},
   watcher = {},
-  graph = null;
+  graph = null,
+  session = null;
 
-watcher.reset = function(opts) {
-  config = clonedeep(opts || config || {});
-  var options = {
+function graphOptions() {
+  return {
     loadPaths: config.includePath,
     extensions: ['scss', 'sass', 'css'],
     follow: config.follow,
   };
+}
+
+watcher.reset = function(opts) {
+  config = clonedeep(opts || config || {});
+  var options = graphOptions();
 
   if (config.directory) {
     graph = grapher.parseDir(config.directory, options);
@@ -22,6 +27,78 @@ watcher.reset = function(opts) {
   return Object.keys(graph.index);
 };
 
+/**
+ * Use the import graph recorded by libsass while rendering
+ * with `sheetCache` instead of parsing all files on every change.
+ * Only safe once every entry point has been rendered successfully.
+ *
+ * @param {Object} sass
+ * @api public
+ */
+
+watcher.useSession = function(sass) {
+  session = sass;
+};
+
+// the session may hold entries of other renders
+function isWatched(file) {
+  if (config.directory) {
+    var relative = path.relative(path.resolve(config.directory), file);
+    return relative.indexOf('..') !== 0 && !path.isAbsolute(relative);
+  }
+  return file === path.resolve(config.src) || (graph !== null && file in graph.index);
+}
+
+function fromSession(absolutePath) {
+  var files = {
+    added: [],
+    changed: [],
+    removed: [],
+  };
+
+  if (path.basename(absolutePath)[0] !== '_') {
+    files.changed.push(absolutePath);
+  }
+
+  session.fileChanged(absolutePath).forEach(function(entry) {
+    if (path.basename(entry)[0] !== '_' && isWatched(entry) && files.changed.indexOf(entry) === -1) {
+      files.changed.push(entry);
+    }
+  });
+
+  return files;
+}
+
+/**
+ * Entry points to compile, i.e. the source file or the files
+ * of the source directory that are not partials (files found
+ * through the include paths are left out)
+ *
+ * @api public
+ */
+
+watcher.entries = function() {
+  if (!config.directory) {
+    return [path.resolve(config.src)];
+  }
+  return Object.keys(graph.index).filter(function(file) {
+    return path.basename(file)[0] !== '_' && isWatched(file);
+  });
+};
+
+/**
+ * Files imported by an entry point as of its last render,
+ * imports added by a change are known once the entry has
+ * been compiled again (none without the session)
+ *
+ * @param {String} entry
+ * @api public
+ */
+
+watcher.imports = function(entry) {
+  return session ? session.getDependencies(entry) : [];
+};
+
 watcher.changed = function(absolutePath) {
   var files = {
     added: [],
@@ -29,6 +106,10 @@ watcher.changed = function(absolutePath) {
     removed: [],
   };
 
+  if (session) {
+    return fromSession(absolutePath);
+  }
+
   this.reset();
 
   if (absolutePath && path.basename(absolutePath)[0] !== '_') {
@@ -55,6 +136,12 @@ watcher.added = function(absolutePath) {
     removed: [],
   };
 
+  if (session) {
+    files = fromSession(absolutePath);
+    files.added.push(absolutePath);
+    return files;
+  }
+
   this.reset();
 
   if (Object.keys(graph.index).indexOf(absolutePath) === -1) {
@@ -75,6 +162,15 @@ watcher.removed = function(absolutePath) {
     removed: [],
   };
 
+  if (session) {
+    files = fromSession(absolutePath);
+    files.changed = files.changed.filter(function(file) {
+      return file !== absolutePath;
+    });
+    files.removed.push(absolutePath);
+    return files;
+  }
+
   graph.visitAncestors(absolutePath, function(parent) {
     if (path.basename(parent)[0] !== '_') {
       files.changed.push(parent);
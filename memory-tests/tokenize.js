@@ -0,0 +1,43 @@
+'use strict';
+
+// Measures the compile time of a big plain CSS stylesheet (like
+// vendor CSS imported into SCSS), which is mostly tokenization:
+//   node memory-tests/tokenize.js
+
+var sass = require('../');
+
+var props = [
+  'display: block',
+  'box-sizing: border-box',
+  'font-family: -apple-system, "Segoe UI", Roboto, "Helvetica Neue", Arial, sans-serif',
+  'background-color: rgba(0, 0, 0, 0.075)',
+  'transition: color .15s ease-in-out, border-color .15s ease-in-out',
+  'padding: .375rem .75rem'
+];
+var rules = [];
+
+for (var i = 0; i < 10000; i++) {
+  if (i % 40 === 0) {
+    rules.push('/* ------------------------------------------------\n   Section ' + i + '\n   ------------------------------------------------ */');
+  }
+  if (i % 3 === 0) {
+    rules.push('.icon-glyph-' + i + ':before {\n  content: "\\f' + (i % 4096).toString(16) + '";\n}');
+  }
+  else {
+    rules.push(
+      '.btn-outline-' + i + ':not(:disabled):not(.disabled).active, .btn-outline-' + i + ' > .nav-link:hover {\n' +
+      '  ' + props[i % props.length] + ';\n  ' + props[(i * 7) % props.length] + ';\n}'
+    );
+  }
+}
+
+var data = rules.join('\n\n');
+var best = Infinity;
+
+for (var n = 0; n < 10; n++) {
+  var start = Date.now();
+  sass.renderSync({ data: data });
+  best = Math.min(best, Date.now() - start);
+}
+
+console.log('size: %dkB, best time: %dms', Math.round(data.length / 1000), best);
@@ -0,0 +1,65 @@
+#include <atomic>
+#include <nan.h>
+#include "addon_data.h"
+
+// JavaScript runs on one thread per environment
+static thread_local AddonData* current_data = 0;
+
+AddonData* AddonData::current() {
+  return current_data;
+}
+
+AddonData* AddonData::init() {
+  /*
+   * This is invoked from the JavaScript thread.
+   * V8 context is available.
+   */
+  // the module may be loaded again (i.e. after
+  // it was removed from the require cache)
+  if (current_data) return current_data;
+
+  current_data = new AddonData(Nan::GetCurrentEventLoop());
+  sass_value_pool_enter(current_data->value_pool);
+
+#if NODE_MAJOR_VERSION > 10 || (NODE_MAJOR_VERSION == 10 && NODE_MINOR_VERSION >= 2)
+  // workers may exit while the process goes on
+  node::AddEnvironmentCleanupHook(v8::Isolate::GetCurrent(), cleanup, current_data);
+#endif
+
+  return current_data;
+}
+
+AddonData::AddonData(uv_loop_t* loop)
+  : loop(loop), dispatcher(new CallDispatcher(loop)), value_pool(sass_make_value_pool()),
+    function_cache(sass_make_function_cache()) {
+}
+
+AddonData::~AddonData() {
+  for (auto& constructor : constructors) {
+    constructor.second.Reset();
+  }
+  sass_true.Reset();
+  sass_false.Reset();
+  sass_null.Reset();
+  sass_delete_value_pool(value_pool);
+  sass_delete_function_cache(function_cache);
+}
+
+size_t AddonData::next_id() {
+  // ids are shared by all environments
+  static std::atomic<size_t> next(0);
+  return next++;
+}
+
+void AddonData::cleanup(void* arg) {
+  /*
+   * This is invoked from the JavaScript thread
+   * while the environment is torn down.
+   */
+  AddonData* data = static_cast<AddonData*>(arg);
+  // renders waiting for JavaScript fail, finished ones are dropped
+  data->dispatcher->shutdown();
+  sass_value_pool_leave(data->value_pool);
+  current_data = 0;
+  delete data;
+}
@@ -0,0 +1,64 @@
+#ifndef ADDON_DATA_H
+#define ADDON_DATA_H
+
+#include <map>
+#include <nan.h>
+#include <uv.h>
+#include <sass/context.h>
+#include <sass/values.h>
+#include "call_dispatcher.h"
+
+// State of the binding in one Node.js environment, i.e. on the main
+// thread or in a worker thread. Every environment loads the addon with
+// its own isolate and event loop, so handles and constructors must not
+// be shared between them. Caches of libsass are thread safe and stay
+// shared by the whole process, except for results of custom functions.
+class AddonData {
+  public:
+    // The state of the environment running JavaScript on the
+    // calling thread (null on compile threads)
+    static AddonData* current();
+
+    // Creates the state of the environment being initialized
+    // (once per environment, from the module initializer)
+    static AddonData* init();
+
+    // The event loop of the environment
+    uv_loop_t* const loop;
+
+    // Runs calls of compile threads on the loop
+    CallDispatcher* const dispatcher;
+
+    // Recycles Sass values made and deleted on the JavaScript thread,
+    // e.g. by the sass types and custom function results (renders use
+    // a pool of their own while they run)
+    struct Sass_Value_Pool* const value_pool;
+
+    // Results of pure custom functions shared by the renders of the
+    // environment that set `functionCache` (a compiler or batch keeps
+    // its own, workers may register other functions)
+    struct Sass_Function_Cache* const function_cache;
+
+    // The JavaScript constructor of class `T` (empty until created)
+    template <class T>
+    Nan::Persistent<v8::Function>& constructor() {
+      static const size_t id = next_id();
+      return constructors[id];
+    }
+
+    // Instances of SassBoolean and SassNull
+    Nan::Persistent<v8::Object> sass_true;
+    Nan::Persistent<v8::Object> sass_false;
+    Nan::Persistent<v8::Object> sass_null;
+
+  private:
+    explicit AddonData(uv_loop_t*);
+    ~AddonData();
+
+    std::map<size_t, Nan::Persistent<v8::Function>> constructors;
+
+    static size_t next_id();
+    static void cleanup(void*);
+};
+
+#endif
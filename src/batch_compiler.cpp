@@ -0,0 +1,368 @@
+#include <algorithm>
+#include <nan.h>
+#include <stdlib.h>
+#include <string.h>
+#include "batch_compiler.h"
+#include "create_string.h"
+#include "take_buffer.h"
+
+static std::string get_string(v8::Local<v8::Object> options, const char* name) {
+  char* str = create_string(Nan::Get(options, Nan::New(name).ToLocalChecked()));
+  std::string rv(str ? str : "");
+  free(str);
+  return rv;
+}
+
+static int32_t get_int(v8::Local<v8::Object> options, const char* name) {
+  return Nan::To<int32_t>(Nan::Get(options, Nan::New(name).ToLocalChecked()).ToLocalChecked()).FromJust();
+}
+
+static uint32_t get_uint(v8::Local<v8::Object> options, const char* name) {
+  return Nan::To<uint32_t>(Nan::Get(options, Nan::New(name).ToLocalChecked()).ToLocalChecked()).FromJust();
+}
+
+static bool get_bool(v8::Local<v8::Object> options, const char* name) {
+  return Nan::To<bool>(Nan::Get(options, Nan::New(name).ToLocalChecked()).ToLocalChecked()).FromJust();
+}
+
+static const char* c_str_or_null(const std::string& str) {
+  return str.empty() ? 0 : str.c_str();
+}
+
+static void get_functions(v8::Local<v8::Object> options, const char* name, std::vector<v8::Local<v8::Function>>& callbacks) {
+  v8::Local<v8::Value> value = Nan::Get(options, Nan::New(name).ToLocalChecked()).ToLocalChecked();
+  if (value->IsFunction()) {
+    callbacks.push_back(value.As<v8::Function>());
+  }
+  else if (value->IsArray()) {
+    v8::Local<v8::Array> array = value.As<v8::Array>();
+    for (uint32_t i = 0; i < array->Length(); ++i) {
+      callbacks.push_back(Nan::Get(array, i).ToLocalChecked().As<v8::Function>());
+    }
+  }
+}
+
+BatchCompiler::BatchCompiler(v8::Local<v8::Object> options, CallDispatcher* dispatcher, struct Sass_Session* session, struct Sass_File_Cache* file_cache)
+  : session(session), file_cache(file_cache), function_cache(0), next(0), taken(0), stopping(false), notified(false), delivered(0), dispatcher(dispatcher) {
+  /*
+   * This is invoked from the main JavaScript thread.
+   * V8 context is available.
+   */
+  include_path = get_string(options, "includePaths");
+  source_map_root = get_string(options, "sourceMapRoot");
+  linefeed = get_string(options, "linefeed");
+  indent = std::string(get_int(options, "indentWidth"), get_int(options, "indentType") == 1 ? '\t' : ' ');
+  style = get_int(options, "style");
+  precision = get_int(options, "precision");
+  indented_syntax = get_bool(options, "indentedSyntax");
+  source_comments = get_bool(options, "sourceComments");
+  omit_source_map_url = get_bool(options, "omitSourceMapUrl");
+  source_map_embed = get_bool(options, "sourceMapEmbed");
+  source_map_contents = get_bool(options, "sourceMapContents");
+  import_threads = get_int(options, "importThreads");
+  mmap_sources = get_bool(options, "mmapSources");
+  timeout = get_uint(options, "timeout");
+  // not shared with other batches, their functions may differ
+  if (get_bool(options, "functionCache")) function_cache = sass_make_function_cache();
+
+  v8::Local<v8::Array> files = Nan::Get(options, Nan::New("entries").ToLocalChecked()).ToLocalChecked().As<v8::Array>();
+  entries.resize(files->Length());
+  for (uint32_t i = 0; i < files->Length(); ++i) {
+    v8::Local<v8::Object> entry = Nan::To<v8::Object>(Nan::Get(files, i).ToLocalChecked()).ToLocalChecked();
+    entries[i].file = get_string(entry, "file");
+    entries[i].out_file = get_string(entry, "outFile");
+    entries[i].source_map = get_string(entry, "sourceMap");
+    entries[i].fctx = 0;
+  }
+
+  concurrency = static_cast<size_t>(get_int(options, "concurrency"));
+  if (concurrency < 1) concurrency = 1;
+  if (concurrency > entries.size()) concurrency = entries.size();
+
+  std::vector<v8::Local<v8::Function>> importers;
+  std::vector<v8::Local<v8::Function>> functions;
+  get_functions(options, "importer", importers);
+
+  v8::Local<v8::Value> custom_functions = Nan::Get(options, Nan::New("functions").ToLocalChecked()).ToLocalChecked();
+  if (custom_functions->IsObject()) {
+    v8::Local<v8::Object> object = custom_functions.As<v8::Object>();
+    v8::Local<v8::Array> names = Nan::GetOwnPropertyNames(object).ToLocalChecked();
+
+    for (uint32_t i = 0; i < names->Length(); ++i) {
+      v8::Local<v8::Value> signature = Nan::Get(names, i).ToLocalChecked();
+      v8::Local<v8::Function> callback = Nan::Get(object, signature).ToLocalChecked().As<v8::Function>();
+
+      char* sig = create_string(signature);
+      signatures.push_back(sig);
+      free(sig);
+      pure.push_back(Nan::To<bool>(Nan::Get(callback, Nan::New("pure").ToLocalChecked()).ToLocalChecked()).FromJust());
+      functions.push_back(callback);
+    }
+  }
+
+  // a bridge waits for one call at a time
+  bridges.resize(concurrency);
+  for (bridge_set& set : bridges) {
+    for (v8::Local<v8::Function> callback : functions) {
+      set.functions.push_back(new CustomFunctionBridge(callback, false));
+    }
+    for (v8::Local<v8::Function> callback : importers) {
+      set.importers.push_back(new CustomImporterBridge(callback, false));
+    }
+  }
+
+  result_callback = new Nan::Callback(Nan::Get(options, Nan::New("result").ToLocalChecked()).ToLocalChecked().As<v8::Function>());
+  done_callback = new Nan::Callback(Nan::Get(options, Nan::New("done").ToLocalChecked()).ToLocalChecked().As<v8::Function>());
+  async_resource = new Nan::AsyncResource("node-sass:batch_compiler");
+
+  uv_mutex_init(&mutex);
+}
+
+BatchCompiler::~BatchCompiler() {
+  for (batch_entry& entry : entries) {
+    if (entry.fctx) sass_delete_file_context(entry.fctx);
+  }
+  for (bridge_set& set : bridges) {
+    for (CustomFunctionBridge* bridge : set.functions) delete bridge;
+    for (CustomImporterBridge* bridge : set.importers) delete bridge;
+  }
+  delete result_callback;
+  delete done_callback;
+  delete async_resource;
+  sass_delete_function_cache(function_cache);
+  uv_mutex_destroy(&mutex);
+}
+
+void BatchCompiler::start() {
+  // keep the loop alive until done
+  dispatcher->hold(this);
+  if (entries.empty()) {
+    // nothing to do, still report done asynchronously
+    notified = true;
+    dispatcher->enqueue(this);
+    return;
+  }
+  workers.resize(concurrency);
+  size_t started = 0;
+  for (size_t i = 0; i < concurrency; ++i) {
+    if (uv_thread_create(&workers[started], work, this) == 0) started++;
+  }
+  // only join the threads that are running
+  workers.resize(started);
+  if (started == 0) {
+    // no worker at all, every entry fails
+    next = entries.size();
+    for (size_t i = 0; i < entries.size(); ++i) finished.push_back(i);
+    notified = true;
+    dispatcher->enqueue(this);
+  }
+}
+
+void BatchCompiler::apply_options(Sass_Options* sass_options, const batch_entry& entry, const bridge_set& set) const {
+  sass_option_set_output_path(sass_options, c_str_or_null(entry.out_file));
+  sass_option_set_output_style(sass_options, (Sass_Output_Style) style);
+  sass_option_set_is_indented_syntax_src(sass_options, indented_syntax);
+  sass_option_set_source_comments(sass_options, source_comments);
+  sass_option_set_omit_source_map_url(sass_options, omit_source_map_url);
+  sass_option_set_source_map_embed(sass_options, source_map_embed);
+  sass_option_set_source_map_contents(sass_options, source_map_contents);
+  sass_option_set_import_threads(sass_options, import_threads);
+  sass_option_set_mmap_sources(sass_options, mmap_sources);
+  sass_option_set_timeout(sass_options, timeout);
+  sass_option_set_source_map_file(sass_options, c_str_or_null(entry.source_map));
+  sass_option_set_source_map_root(sass_options, c_str_or_null(source_map_root));
+  sass_option_set_include_path(sass_options, c_str_or_null(include_path));
+  sass_option_set_precision(sass_options, precision);
+  sass_option_set_indent(sass_options, indent.c_str());
+  sass_option_set_linefeed(sass_options, c_str_or_null(linefeed));
+  if (session) sass_option_set_session(sass_options, session);
+  if (file_cache) sass_option_set_file_cache(sass_options, file_cache);
+  if (function_cache) sass_option_set_function_cache(sass_options, function_cache);
+
+  // the lists are owned by the context (built for every entry)
+  if (!set.importers.empty()) {
+    size_t count = set.importers.size();
+    Sass_Importer_List c_importers = sass_make_importer_list(count);
+    for (size_t i = 0; i < count; ++i) {
+      c_importers[i] = sass_make_importer(sass_importer, count - i - 1, set.importers[i]);
+    }
+    sass_option_set_c_importers(sass_options, c_importers);
+  }
+
+  if (!set.functions.empty()) {
+    size_t count = set.functions.size();
+    Sass_Function_List fn_list = sass_make_function_list(count);
+    for (size_t i = 0; i < count; ++i) {
+      Sass_Function_Entry fn = sass_make_function(signatures[i].c_str(), sass_custom_function, set.functions[i]);
+      sass_function_set_pure(fn, pure[i]);
+      sass_function_set_list_entry(fn_list, i, fn);
+    }
+    sass_option_set_c_functions(sass_options, fn_list);
+  }
+}
+
+void BatchCompiler::work(void* arg) {
+  /*
+   * This is invoked from a batch worker thread.
+   * No V8 context and functions available.
+   */
+  BatchCompiler* batch = static_cast<BatchCompiler*>(arg);
+
+  uv_mutex_lock(&batch->mutex);
+  const bridge_set& set = batch->bridges[batch->taken++];
+  uv_mutex_unlock(&batch->mutex);
+
+  for (;;) {
+    uv_mutex_lock(&batch->mutex);
+    size_t index = batch->next++;
+    uv_mutex_unlock(&batch->mutex);
+
+    if (index >= batch->entries.size()) break;
+
+    batch_entry& entry = batch->entries[index];
+    Sass_File_Context* fctx = sass_make_file_context(entry.file.c_str());
+    batch->apply_options(sass_file_context_get_options(fctx), entry, set);
+    if (sass_context_get_error_status(sass_file_context_get_context(fctx)) == 0) {
+      // compiled step by step, so cancel can stop it
+      struct Sass_Compiler* compiler = sass_make_file_compiler(fctx);
+      uv_mutex_lock(&batch->mutex);
+      batch->running.push_back(compiler);
+      // stop ran before the compile was listed
+      if (batch->stopping) sass_compiler_cancel(compiler);
+      uv_mutex_unlock(&batch->mutex);
+      sass_compiler_parse(compiler);
+      uv_mutex_lock(&batch->mutex);
+      bool stopping = batch->stopping;
+      uv_mutex_unlock(&batch->mutex);
+      if (!stopping) sass_compiler_execute(compiler);
+      uv_mutex_lock(&batch->mutex);
+      batch->running.erase(std::find(batch->running.begin(), batch->running.end(), compiler));
+      uv_mutex_unlock(&batch->mutex);
+      sass_delete_compiler(compiler);
+    }
+    entry.fctx = fctx;
+
+    uv_mutex_lock(&batch->mutex);
+    batch->finished.push_back(index);
+    // queued once, the main thread drains all finished entries
+    bool notify = !batch->notified;
+    batch->notified = true;
+    uv_mutex_unlock(&batch->mutex);
+
+    if (notify) batch->dispatcher->enqueue(batch);
+  }
+}
+
+void BatchCompiler::deliver(size_t index) {
+  Nan::HandleScope scope;
+
+  batch_entry& entry = entries[index];
+  // entries are never compiled without workers
+  struct Sass_Context* ctx = entry.fctx ? sass_file_context_get_context(entry.fctx) : 0;
+  v8::Local<v8::Object> result = Nan::New<v8::Object>();
+
+  if (!ctx) {
+    Nan::Set(result, Nan::New("error").ToLocalChecked(), Nan::New<v8::String>(
+      "{\n  \"status\": 3,\n  \"message\": \"Unable to start a compile thread\",\n"
+      "  \"formatted\": \"Error: Unable to start a compile thread\"\n}\n").ToLocalChecked());
+  }
+  else if (sass_context_get_error_status(ctx) == 0) {
+    // hand the strings over to the buffers (no copies)
+    char* css = sass_context_take_output_string(ctx);
+    char* map = sass_context_take_source_map_string(ctx);
+    char** included_files = sass_context_get_included_files(ctx);
+    v8::Local<v8::Array> arr = Nan::New<v8::Array>();
+
+    if (included_files) {
+      for (int i = 0; included_files[i] != nullptr; ++i) {
+        Nan::Set(arr, i, Nan::New<v8::String>(included_files[i]).ToLocalChecked());
+      }
+    }
+
+    Nan::Set(result, Nan::New("css").ToLocalChecked(), take_buffer(css));
+    Nan::Set(result, Nan::New("includedFiles").ToLocalChecked(), arr);
+
+    if (map) {
+      Nan::Set(result, Nan::New("map").ToLocalChecked(), take_buffer(map));
+    }
+  }
+  else {
+    Nan::Set(result, Nan::New("error").ToLocalChecked(), Nan::New<v8::String>(sass_context_get_error_json(ctx)).ToLocalChecked());
+  }
+
+  // release memory as early as possible
+  if (entry.fctx) sass_delete_file_context(entry.fctx);
+  entry.fctx = 0;
+
+  v8::Local<v8::Value> argv[] = {
+    Nan::New<v8::Number>(static_cast<double>(index)),
+    result
+  };
+  result_callback->Call(2, argv, async_resource);
+}
+
+void BatchCompiler::dispatch() {
+  /*
+   * Function called in the main thread.
+   * Delivers all entries finished since the last call.
+   */
+  Nan::HandleScope scope;
+  Nan::TryCatch try_catch;
+
+  std::vector<size_t> finished;
+  uv_mutex_lock(&mutex);
+  finished.swap(this->finished);
+  notified = false;
+  uv_mutex_unlock(&mutex);
+
+  for (size_t index : finished) {
+    deliver(index);
+    delivered++;
+    if (try_catch.HasCaught()) {
+      Nan::FatalException(try_catch);
+      try_catch.Reset();
+    }
+  }
+
+  if (delivered < entries.size()) return;
+
+  // all workers are done or about to exit
+  for (uv_thread_t& worker : workers) {
+    uv_thread_join(&worker);
+  }
+
+  done_callback->Call(0, 0, async_resource);
+  if (try_catch.HasCaught()) {
+    Nan::FatalException(try_catch);
+  }
+
+  dispatcher->release(this);
+  delete this;
+}
+
+void BatchCompiler::stop() {
+  /*
+   * The environment exits (called on its JavaScript thread).
+   * Running entries are stopped, others are not started.
+   */
+  uv_mutex_lock(&mutex);
+  next = entries.size();
+  stopping = true;
+  for (struct Sass_Compiler* compiler : running) {
+    sass_compiler_cancel(compiler);
+  }
+  uv_mutex_unlock(&mutex);
+}
+
+void BatchCompiler::cancel() {
+  /*
+   * The batch is abandoned once its workers stopped,
+   * it is freed while V8 is still around.
+   */
+  for (uv_thread_t& worker : workers) {
+    uv_thread_join(&worker);
+  }
+
+  dispatcher->release(this);
+  delete this;
+}
@@ -0,0 +1,102 @@
+#ifndef BATCH_COMPILER_H
+#define BATCH_COMPILER_H
+
+#include <string>
+#include <vector>
+#include <nan.h>
+#include <uv.h>
+#include <sass/context.h>
+#include "call_dispatcher.h"
+#include "custom_function_bridge.h"
+#include "custom_importer_bridge.h"
+
+// One entry file of a batch and its compilation state
+struct batch_entry {
+  std::string file;
+  std::string out_file;
+  std::string source_map;
+  Sass_File_Context* fctx;
+};
+
+// Compiles many entry files with one set of options on its own pool
+// of worker threads. Options are extracted once on the main thread and
+// finished entries are reported back in chunks through the dispatcher
+// of the environment. Each worker calls custom functions and importers
+// through a set of bridges of its own. The object deletes itself after
+// the done callback was called, or once its workers stopped when the
+// environment exits.
+class BatchCompiler : public CallDispatcher::Call {
+  public:
+    BatchCompiler(v8::Local<v8::Object>, CallDispatcher*, struct Sass_Session*, struct Sass_File_Cache*);
+    ~BatchCompiler();
+
+    // Spawns the workers (called on the main thread)
+    void start();
+
+    // Delivers all entries finished since the last call
+    void dispatch();
+    void stop();
+    void cancel();
+
+  private:
+    // Settings shared by all entries
+    std::string include_path;
+    std::string source_map_root;
+    std::string linefeed;
+    std::string indent;
+    int style;
+    int precision;
+    int import_threads;
+    size_t timeout;
+    bool indented_syntax;
+    bool source_comments;
+    bool omit_source_map_url;
+    bool source_map_embed;
+    bool source_map_contents;
+    bool mmap_sources;
+    struct Sass_Session* session;
+    struct Sass_File_Cache* file_cache;
+    // results of its pure functions (with functionCache)
+    struct Sass_Function_Cache* function_cache;
+
+    // Bridges used by one worker
+    struct bridge_set {
+      std::vector<CustomFunctionBridge*> functions;
+      std::vector<CustomImporterBridge*> importers;
+    };
+
+    // Custom functions (same order as the bridges)
+    std::vector<std::string> signatures;
+    std::vector<bool> pure;
+    std::vector<bridge_set> bridges;
+
+    std::vector<batch_entry> entries;
+    std::vector<uv_thread_t> workers;
+    size_t concurrency;
+
+    // Guards the fields below
+    uv_mutex_t mutex;
+    size_t next;
+    // bridge sets taken by the workers
+    size_t taken;
+    // compiles of the workers (stopped on cancel)
+    std::vector<struct Sass_Compiler*> running;
+    // set by stop, compiles listed later are cancelled at once
+    bool stopping;
+    std::vector<size_t> finished;
+    // queued on the dispatcher, not yet delivered
+    bool notified;
+    size_t delivered;
+
+    CallDispatcher* dispatcher;
+    Nan::Callback* result_callback;
+    Nan::Callback* done_callback;
+    Nan::AsyncResource* async_resource;
+
+    void apply_options(Sass_Options*, const batch_entry&, const bridge_set&) const;
+    void deliver(size_t);
+
+    static void work(void*);
+};
+
+#endif
@@ -1,38 +1,23 @@
 #include <nan.h>
 #include <vector>
+#include "addon_data.h"
 #include "sass_context_wrapper.h"
+#include "batch_compiler.h"
+#include "compile_pool.h"
+#include "compiler.h"
+#include "call_dispatcher.h"
 #include "custom_function_bridge.h"
+#include "output_sink.h"
 #include "create_string.h"
+#include "take_buffer.h"
 #include "sass_types/factory.h"
 
-Sass_Import_List sass_importer(const char* cur_path, Sass_Importer_Entry cb, struct Sass_Compiler* comp)
-{
-  void* cookie = sass_importer_get_cookie(cb);
-  struct Sass_Import* previous = sass_compiler_get_last_import(comp);
-  const char* prev_path = sass_import_get_abs_path(previous);
-  CustomImporterBridge& bridge = *(static_cast<CustomImporterBridge*>(cookie));
+// import graph and parsed stylesheets shared by all compilations of the process
+static struct Sass_Session* session = sass_make_session();
 
-  std::vector<void*> argv;
-  argv.push_back((void*)cur_path);
-  argv.push_back((void*)prev_path);
-
-  return bridge(argv);
-}
-
-union Sass_Value* sass_custom_function(const union Sass_Value* s_args, Sass_Function_Entry cb, struct Sass_Compiler* comp)
-{
-  void* cookie = sass_function_get_cookie(cb);
-  CustomFunctionBridge& bridge = *(static_cast<CustomFunctionBridge*>(cookie));
-
-  std::vector<void*> argv;
-  for (unsigned l = sass_list_get_length(s_args), i = 0; i < l; i++) {
-    argv.push_back((void*)sass_list_get_value(s_args, i));
-  }
-
-  return bridge(argv);
-}
-
-int ExtractOptions(v8::Local<v8::Object> options, void* cptr, sass_context_wrapper* ctx_w, bool is_file, bool is_sync) {
+// Per render parts of the options: the result object, callbacks and the
+// path of the input (returns the options of the context, null on error)
+struct Sass_Options* ExtractRender(v8::Local<v8::Object> options, void* cptr, sass_context_wrapper* ctx_w, bool is_file, bool is_sync) {
   Nan::HandleScope scope;
 
   struct Sass_Context* ctx;
@@ -43,7 +28,7 @@ int ExtractOptions(v8::Local<v8::Object> options, void* cptr, sass_context_wrapp
   ).ToLocalChecked();
   if (!result_->IsObject()) {
     Nan::ThrowTypeError("\"result\" element is not an object");
-    return -1;
+    return 0;
   }
 
   ctx_w->result.Reset(result_.As<v8::Object>());
@@ -62,8 +47,6 @@ int ExtractOptions(v8::Local<v8::Object> options, void* cptr, sass_context_wrapp
   ctx_w->is_sync = is_sync;
 
   if (!is_sync) {
-    ctx_w->request.data = ctx_w;
-
     // async (callback) style
     v8::Local<v8::Function> success_callback = v8::Local<v8::Function>::Cast(Nan::Get(options, Nan::New("success").ToLocalChecked()).ToLocalChecked());
     v8::Local<v8::Function> error_callback = v8::Local<v8::Function>::Cast(Nan::Get(options, Nan::New("error").ToLocalChecked()).ToLocalChecked());
@@ -77,6 +60,25 @@ int ExtractOptions(v8::Local<v8::Object> options, void* cptr, sass_context_wrapp
     sass_option_set_input_path(sass_options, ctx_w->file);
   }
 
+  v8::Local<v8::Value> output_callback = Nan::Get(options, Nan::New("output").ToLocalChecked()).ToLocalChecked();
+
+  if (output_callback->IsFunction()) {
+    ctx_w->output_callback = new Nan::Callback(output_callback.As<v8::Function>());
+    ctx_w->dispatcher = AddonData::current()->dispatcher;
+    sass_option_set_output_sink(sass_options, sass_output_sink, ctx_w);
+  }
+
+  return sass_options;
+}
+
+int ExtractOptions(v8::Local<v8::Object> options, void* cptr, sass_context_wrapper* ctx_w, bool is_file, bool is_sync) {
+  Nan::HandleScope scope;
+
+  struct Sass_Options* sass_options = ExtractRender(options, cptr, ctx_w, is_file, is_sync);
+  if (!sass_options) {
+    return -1;
+  }
+
   int indent_len = Nan::To<int32_t>(
     Nan::Get(
         options,
@@ -107,6 +109,9 @@ int ExtractOptions(v8::Local<v8::Object> options, void* cptr, sass_context_wrapp
   sass_option_set_omit_source_map_url(sass_options, Nan::To<bool>(Nan::Get(options, Nan::New("omitSourceMapUrl").ToLocalChecked()).ToLocalChecked()).FromJust());
   sass_option_set_source_map_embed(sass_options, Nan::To<bool>(Nan::Get(options, Nan::New("sourceMapEmbed").ToLocalChecked()).ToLocalChecked()).FromJust());
   sass_option_set_source_map_contents(sass_options, Nan::To<bool>(Nan::Get(options, Nan::New("sourceMapContents").ToLocalChecked()).ToLocalChecked()).FromJust());
+  sass_option_set_import_threads(sass_options, Nan::To<int32_t>(Nan::Get(options, Nan::New("importThreads").ToLocalChecked()).ToLocalChecked()).FromJust());
+  sass_option_set_mmap_sources(sass_options, Nan::To<bool>(Nan::Get(options, Nan::New("mmapSources").ToLocalChecked()).ToLocalChecked()).FromJust());
+  sass_option_set_timeout(sass_options, Nan::To<uint32_t>(Nan::Get(options, Nan::New("timeout").ToLocalChecked()).ToLocalChecked()).FromJust());
   sass_option_set_source_map_file(sass_options, ctx_w->source_map);
   sass_option_set_source_map_root(sass_options, ctx_w->source_map_root);
   sass_option_set_include_path(sass_options, ctx_w->include_path);
@@ -114,6 +119,18 @@ int ExtractOptions(v8::Local<v8::Object> options, void* cptr, sass_context_wrapp
   sass_option_set_indent(sass_options, ctx_w->indent);
   sass_option_set_linefeed(sass_options, ctx_w->linefeed);
 
+  if (Nan::To<bool>(Nan::Get(options, Nan::New("sheetCache").ToLocalChecked()).ToLocalChecked()).FromJust()) {
+    sass_option_set_session(sass_options, session);
+  }
+
+  if (Nan::To<bool>(Nan::Get(options, Nan::New("fileCache").ToLocalChecked()).ToLocalChecked()).FromJust()) {
+    sass_option_set_file_cache(sass_options, sass_session_get_file_cache(session));
+  }
+
+  if (Nan::To<bool>(Nan::Get(options, Nan::New("functionCache").ToLocalChecked()).ToLocalChecked()).FromJust()) {
+    sass_option_set_function_cache(sass_options, AddonData::current()->function_cache);
+  }
+
   v8::Local<v8::Value> importer_callback = Nan::Get(options, Nan::New("importer").ToLocalChecked()).ToLocalChecked();
 
   if (importer_callback->IsFunction()) {
@@ -160,6 +177,7 @@ int ExtractOptions(v8::Local<v8::Object> options, void* cptr, sass_context_wrapp
 
       char* sig = create_string(signature);
       Sass_Function_Entry fn = sass_make_function(sig, sass_custom_function, bridge);
+      sass_function_set_pure(fn, Nan::To<bool>(Nan::Get(callback, Nan::New("pure").ToLocalChecked()).ToLocalChecked()).FromJust());
       free(sig);
       sass_function_set_list_entry(fn_list, i, fn);
     }
@@ -169,6 +187,39 @@ int ExtractOptions(v8::Local<v8::Object> options, void* cptr, sass_context_wrapp
   return 0;
 }
 
+v8::Local<v8::Object> MakeTiming(const char* count_key, double count, double time) {
+  v8::Local<v8::Object> timing = Nan::New<v8::Object>();
+  Nan::Set(timing, Nan::New(count_key).ToLocalChecked(), Nan::New<v8::Number>(count));
+  Nan::Set(timing, Nan::New("time").ToLocalChecked(), Nan::New<v8::Number>(time));
+  return timing;
+}
+
+void SetProfile(v8::Local<v8::Object> stats, Sass_Context* ctx) {
+  v8::Local<v8::Object> phases = Nan::New<v8::Object>();
+
+  for (int i = SASS_PHASE_PARSE; i <= SASS_PHASE_SOURCE_MAP; ++i) {
+    Sass_Compiler_Phase phase = static_cast<Sass_Compiler_Phase>(i);
+    Nan::Set(
+      phases,
+      Nan::New(sass_compiler_phase_name(phase)).ToLocalChecked(),
+      MakeTiming("allocations", static_cast<double>(sass_context_get_phase_allocations(ctx, phase)), sass_context_get_phase_time(ctx, phase))
+    );
+  }
+
+  Nan::Set(stats, Nan::New("phases").ToLocalChecked(), phases);
+  Nan::Set(stats, Nan::New("functions").ToLocalChecked(),
+    MakeTiming("calls", static_cast<double>(sass_context_get_function_calls(ctx)), sass_context_get_function_time(ctx)));
+  Nan::Set(stats, Nan::New("importers").ToLocalChecked(),
+    MakeTiming("calls", static_cast<double>(sass_context_get_importer_calls(ctx)), sass_context_get_importer_time(ctx)));
+
+  v8::Local<v8::Object> lookaheads = Nan::New<v8::Object>();
+  Nan::Set(lookaheads, Nan::New("probes").ToLocalChecked(), Nan::New<v8::Number>(static_cast<double>(sass_context_get_lookahead_probes(ctx))));
+  Nan::Set(lookaheads, Nan::New("hits").ToLocalChecked(), Nan::New<v8::Number>(static_cast<double>(sass_context_get_lookahead_hits(ctx))));
+  Nan::Set(lookaheads, Nan::New("scanned").ToLocalChecked(), Nan::New<v8::Number>(static_cast<double>(sass_context_get_lookahead_scanned(ctx))));
+  Nan::Set(lookaheads, Nan::New("saved").ToLocalChecked(), Nan::New<v8::Number>(static_cast<double>(sass_context_get_lookahead_saved(ctx))));
+  Nan::Set(stats, Nan::New("lookaheads").ToLocalChecked(), lookaheads);
+}
+
 void GetStats(sass_context_wrapper* ctx_w, Sass_Context* ctx) {
   Nan::HandleScope scope;
 
@@ -194,6 +245,7 @@ void GetStats(sass_context_wrapper* ctx_w, Sass_Context* ctx) {
       Nan::New("includedFiles").ToLocalChecked(),
       arr
     );
+    SetProfile(stats.As<v8::Object>(), ctx);
   } else {
     Nan::ThrowTypeError("\"result.stats\" element is not an object");
   }
@@ -209,15 +261,16 @@ int GetResult(sass_context_wrapper* ctx_w, Sass_Context* ctx, bool is_sync = fal
   assert(result->IsObject());
 
   if (status == 0) {
-    const char* css = sass_context_get_output_string(ctx);
-    const char* map = sass_context_get_source_map_string(ctx);
+    // hand the strings over to the buffers (no copies)
+    char* css = sass_context_take_output_string(ctx);
+    char* map = sass_context_take_source_map_string(ctx);
 
-    Nan::Set(result, Nan::New("css").ToLocalChecked(), Nan::CopyBuffer(css, static_cast<uint32_t>(strlen(css))).ToLocalChecked());
+    Nan::Set(result, Nan::New("css").ToLocalChecked(), take_buffer(css));
 
     GetStats(ctx_w, ctx);
 
     if (map) {
-      Nan::Set(result, Nan::New("map").ToLocalChecked(), Nan::CopyBuffer(map, static_cast<uint32_t>(strlen(map))).ToLocalChecked());
+      Nan::Set(result, Nan::New("map").ToLocalChecked(), take_buffer(map));
     }
   }
   else if (is_sync) {
@@ -235,11 +288,11 @@ void PerformCall(sass_context_wrapper* ctx_w, Nan::Callback* callback, int argc,
   }
 }
 
-void MakeCallback(uv_work_t* req) {
+void MakeCallback(void* data, int error) {
   Nan::HandleScope scope;
 
   Nan::TryCatch try_catch;
-  sass_context_wrapper* ctx_w = static_cast<sass_context_wrapper*>(req->data);
+  sass_context_wrapper* ctx_w = static_cast<sass_context_wrapper*>(data);
   struct Sass_Context* ctx;
 
   if (ctx_w->dctx) {
@@ -249,7 +302,8 @@ void MakeCallback(uv_work_t* req) {
     ctx = sass_file_context_get_context(ctx_w->fctx);
   }
 
-  int status = GetResult(ctx_w, ctx);
+  // without a compile thread the render never ran
+  int status = error == 0 ? GetResult(ctx_w, ctx) : 3;
 
   if (status == 0 && ctx_w->success_callback) {
     // if no error, do callback(null, result)
@@ -257,7 +311,9 @@ void MakeCallback(uv_work_t* req) {
   }
   else if (ctx_w->error_callback) {
     // if error, do callback(error)
-    const char* err = sass_context_get_error_json(ctx);
+    const char* err = error == 0 ? sass_context_get_error_json(ctx) :
+      "{\n  \"status\": 3,\n  \"message\": \"Unable to start a compile thread\",\n"
+      "  \"formatted\": \"Error: Unable to start a compile thread\"\n}\n";
     v8::Local<v8::Value> argv[] = {
       Nan::New<v8::String>(err).ToLocalChecked()
     };
@@ -281,9 +337,7 @@ NAN_METHOD(render) {
 
   if (ExtractOptions(options, dctx, ctx_w, false, false) >= 0) {
 
-    int status = uv_queue_work(uv_default_loop(), &ctx_w->request, compile_it, (uv_after_work_cb)MakeCallback);
-
-    assert(status == 0);
+    CompilePool::instance().submit(AddonData::current()->dispatcher, compile_it, MakeCallback, stop_it, free_it, ctx_w);
   }
 }
 
@@ -317,8 +371,7 @@ NAN_METHOD(render_file) {
 
   if (ExtractOptions(options, fctx, ctx_w, true, false) >= 0) {
 
-    int status = uv_queue_work(uv_default_loop(), &ctx_w->request, compile_it, (uv_after_work_cb)MakeCallback);
-    assert(status == 0);
+    CompilePool::instance().submit(AddonData::current()->dispatcher, compile_it, MakeCallback, stop_it, free_it, ctx_w);
   }
 }
 
@@ -342,17 +395,201 @@ NAN_METHOD(render_file_sync) {
   info.GetReturnValue().Set(result == 0);
 }
 
+NAN_METHOD(render_batch) {
+
+  v8::Local<v8::Object> options = Nan::To<v8::Object>(info[0]).ToLocalChecked();
+  bool use_sheet_cache = Nan::To<bool>(Nan::Get(options, Nan::New("sheetCache").ToLocalChecked()).ToLocalChecked()).FromJust();
+  bool use_file_cache = Nan::To<bool>(Nan::Get(options, Nan::New("fileCache").ToLocalChecked()).ToLocalChecked()).FromJust();
+  BatchCompiler* batch = new BatchCompiler(options, AddonData::current()->dispatcher, use_sheet_cache ? session : 0,
+    use_file_cache ? sass_session_get_file_cache(session) : 0);
+
+  batch->start();
+}
+
+NAN_METHOD(create_compiler) {
+
+  v8::Local<v8::Object> options = Nan::To<v8::Object>(info[0]).ToLocalChecked();
+  bool use_sheet_cache = Nan::To<bool>(Nan::Get(options, Nan::New("sheetCache").ToLocalChecked()).ToLocalChecked()).FromJust();
+  bool use_file_cache = Nan::To<bool>(Nan::Get(options, Nan::New("fileCache").ToLocalChecked()).ToLocalChecked()).FromJust();
+
+  info.GetReturnValue().Set(Compiler::create(options, use_sheet_cache ? session : 0,
+    use_file_cache ? sass_session_get_file_cache(session) : 0));
+}
+
+// Makes the context of a render through a compiler handle,
+// the input is either `data` or a `file` (null on error)
+sass_context_wrapper* MakeCompilerRender(Compiler* compiler, v8::Local<v8::Object> input, bool is_sync) {
+  sass_context_wrapper* ctx_w = sass_make_context_wrapper();
+  void* cptr;
+  bool is_file = !Nan::Get(input, Nan::New("data").ToLocalChecked()).ToLocalChecked()->IsString();
+
+  if (is_file) {
+    char* input_path = create_string(Nan::Get(input, Nan::New("file").ToLocalChecked()));
+    cptr = sass_make_file_context(input_path);
+    free(input_path);
+  }
+  else {
+    char* source_string = create_string(Nan::Get(input, Nan::New("data").ToLocalChecked()));
+    cptr = sass_make_data_context(source_string);
+  }
+
+  struct Sass_Options* sass_options = ExtractRender(input, cptr, ctx_w, is_file, is_sync);
+  if (!sass_options) {
+    // the context is not owned by the wrapper yet
+    if (is_file) sass_delete_file_context((struct Sass_File_Context*) cptr);
+    else sass_delete_data_context((struct Sass_Data_Context*) cptr);
+    sass_free_context_wrapper(ctx_w);
+    return 0;
+  }
+
+  compiler->start(sass_options, ctx_w);
+  return ctx_w;
+}
+
+NAN_METHOD(compiler_render) {
+
+  Compiler* compiler = Compiler::unwrap(info[0]);
+  v8::Local<v8::Object> input = Nan::To<v8::Object>(info[1]).ToLocalChecked();
+  sass_context_wrapper* ctx_w = MakeCompilerRender(compiler, input, false);
+
+  if (ctx_w) {
+    ctx_w->async_resource = new Nan::AsyncResource("node-sass:sass_context_wrapper:compiler_render");
+
+    CompilePool::instance().submit(AddonData::current()->dispatcher, compile_it, MakeCallback, stop_it, free_it, ctx_w);
+  }
+}
+
+NAN_METHOD(compiler_render_sync) {
+
+  Compiler* compiler = Compiler::unwrap(info[0]);
+  v8::Local<v8::Object> input = Nan::To<v8::Object>(info[1]).ToLocalChecked();
+  sass_context_wrapper* ctx_w = MakeCompilerRender(compiler, input, true);
+  int result = -1;
+
+  if (ctx_w) {
+    compile_it(ctx_w);
+    result = GetResult(ctx_w, ctx_w->dctx ? sass_data_context_get_context(ctx_w->dctx) : sass_file_context_get_context(ctx_w->fctx), true);
+    sass_free_context_wrapper(ctx_w);
+  }
+
+  info.GetReturnValue().Set(result == 0);
+}
+
 NAN_METHOD(libsass_version) {
   info.GetReturnValue().Set(Nan::New<v8::String>(libsass_version()).ToLocalChecked());
 }
 
+NAN_METHOD(invalidate_sheet_cache) {
+  struct Sass_Sheet_Cache* sheet_cache = sass_session_get_sheet_cache(session);
+  if (info.Length() > 0 && info[0]->IsString()) {
+    char* path = create_string(info[0]);
+    sass_sheet_cache_invalidate(sheet_cache, path);
+    free(path);
+  }
+  else {
+    sass_sheet_cache_clear(sheet_cache);
+  }
+}
+
+NAN_METHOD(sheet_cache_stats) {
+  struct Sass_Sheet_Cache* sheet_cache = sass_session_get_sheet_cache(session);
+  v8::Local<v8::Object> stats = Nan::New<v8::Object>();
+  Nan::Set(stats, Nan::New("size").ToLocalChecked(), Nan::New<v8::Number>(static_cast<double>(sass_sheet_cache_get_size(sheet_cache))));
+  Nan::Set(stats, Nan::New("hits").ToLocalChecked(), Nan::New<v8::Number>(static_cast<double>(sass_sheet_cache_get_hits(sheet_cache))));
+  Nan::Set(stats, Nan::New("misses").ToLocalChecked(), Nan::New<v8::Number>(static_cast<double>(sass_sheet_cache_get_misses(sheet_cache))));
+  info.GetReturnValue().Set(stats);
+}
+
+NAN_METHOD(invalidate_file_cache) {
+  struct Sass_File_Cache* file_cache = sass_session_get_file_cache(session);
+  if (info.Length() > 0 && info[0]->IsString()) {
+    char* path = create_string(info[0]);
+    sass_file_cache_invalidate(file_cache, path);
+    free(path);
+  }
+  else {
+    sass_file_cache_clear(file_cache);
+  }
+}
+
+NAN_METHOD(file_cache_stats) {
+  struct Sass_File_Cache* file_cache = sass_session_get_file_cache(session);
+  v8::Local<v8::Object> stats = Nan::New<v8::Object>();
+  Nan::Set(stats, Nan::New("size").ToLocalChecked(), Nan::New<v8::Number>(static_cast<double>(sass_file_cache_get_size(file_cache))));
+  Nan::Set(stats, Nan::New("hits").ToLocalChecked(), Nan::New<v8::Number>(static_cast<double>(sass_file_cache_get_hits(file_cache))));
+  Nan::Set(stats, Nan::New("misses").ToLocalChecked(), Nan::New<v8::Number>(static_cast<double>(sass_file_cache_get_misses(file_cache))));
+  info.GetReturnValue().Set(stats);
+}
+
+NAN_METHOD(clear_function_cache) {
+  sass_function_cache_clear(AddonData::current()->function_cache);
+}
+
+NAN_METHOD(function_cache_stats) {
+  struct Sass_Function_Cache* function_cache = AddonData::current()->function_cache;
+  v8::Local<v8::Object> stats = Nan::New<v8::Object>();
+  Nan::Set(stats, Nan::New("size").ToLocalChecked(), Nan::New<v8::Number>(static_cast<double>(sass_function_cache_get_size(function_cache))));
+  Nan::Set(stats, Nan::New("hits").ToLocalChecked(), Nan::New<v8::Number>(static_cast<double>(sass_function_cache_get_hits(function_cache))));
+  Nan::Set(stats, Nan::New("misses").ToLocalChecked(), Nan::New<v8::Number>(static_cast<double>(sass_function_cache_get_misses(function_cache))));
+  info.GetReturnValue().Set(stats);
+}
+
+NAN_METHOD(callback_stats) {
+  CallDispatcher::stats counters = AddonData::current()->dispatcher->get_stats();
+  v8::Local<v8::Object> stats = Nan::New<v8::Object>();
+  Nan::Set(stats, Nan::New("calls").ToLocalChecked(), Nan::New<v8::Number>(static_cast<double>(counters.calls)));
+  Nan::Set(stats, Nan::New("roundTrips").ToLocalChecked(), Nan::New<v8::Number>(static_cast<double>(counters.round_trips)));
+  Nan::Set(stats, Nan::New("latency").ToLocalChecked(), Nan::New<v8::Number>(counters.latency / 1e6));
+  Nan::Set(stats, Nan::New("maxLatency").ToLocalChecked(), Nan::New<v8::Number>(counters.max_latency / 1e6));
+  info.GetReturnValue().Set(stats);
+}
+
+v8::Local<v8::Array> GetStringList(char** list) {
+  v8::Local<v8::Array> arr = Nan::New<v8::Array>();
+
+  if (list) {
+    for (int i = 0; list[i] != nullptr; ++i) {
+      Nan::Set(arr, i, Nan::New<v8::String>(list[i]).ToLocalChecked());
+    }
+  }
+
+  sass_delete_string_list(list);
+  return arr;
+}
+
+NAN_METHOD(file_changed) {
+  char* path = create_string(info[0]);
+  info.GetReturnValue().Set(GetStringList(path ? sass_session_file_changed(session, path) : 0));
+  free(path);
+}
+
+NAN_METHOD(get_dependencies) {
+  char* path = create_string(info[0]);
+  info.GetReturnValue().Set(GetStringList(path ? sass_session_get_dependencies(session, path) : 0));
+  free(path);
+}
+
 NAN_MODULE_INIT(RegisterModule) {
+  AddonData::init();
   Nan::SetMethod(target, "render", render);
   Nan::SetMethod(target, "renderSync", render_sync);
   Nan::SetMethod(target, "renderFile", render_file);
   Nan::SetMethod(target, "renderFileSync", render_file_sync);
+  Nan::SetMethod(target, "renderBatch", render_batch);
+  Nan::SetMethod(target, "createCompiler", create_compiler);
+  Nan::SetMethod(target, "compilerRender", compiler_render);
+  Nan::SetMethod(target, "compilerRenderSync", compiler_render_sync);
   Nan::SetMethod(target, "libsassVersion", libsass_version);
+  Nan::SetMethod(target, "invalidateSheetCache", invalidate_sheet_cache);
+  Nan::SetMethod(target, "sheetCacheStats", sheet_cache_stats);
+  Nan::SetMethod(target, "invalidateFileCache", invalidate_file_cache);
+  Nan::SetMethod(target, "fileCacheStats", file_cache_stats);
+  Nan::SetMethod(target, "clearFunctionCache", clear_function_cache);
+  Nan::SetMethod(target, "functionCacheStats", function_cache_stats);
+  Nan::SetMethod(target, "callbackStats", callback_stats);
+  Nan::SetMethod(target, "fileChanged", file_changed);
+  Nan::SetMethod(target, "getDependencies", get_dependencies);
   SassTypes::Factory::initExports(target);
 }
 
-NODE_MODULE(binding, RegisterModule);
+NAN_MODULE_WORKER_ENABLED(binding, RegisterModule)
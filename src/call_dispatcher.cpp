@@ -0,0 +1,155 @@
+#include <nan.h>
+#include "call_dispatcher.h"
+
+CallDispatcher::CallDispatcher(uv_loop_t* loop) : closed(false) {
+  /*
+   * This is invoked from the JavaScript thread of the loop.
+   */
+  uv_mutex_init(&mutex);
+  counters.calls = 0;
+  counters.round_trips = 0;
+  counters.latency = 0;
+  counters.max_latency = 0;
+  async.data = this;
+  uv_async_init(loop, &async, (uv_async_cb) dispatched_async_uv_callback);
+  // pending renders keep the loop alive, not the dispatcher
+  uv_unref((uv_handle_t*) &async);
+}
+
+CallDispatcher::~CallDispatcher() {
+  uv_mutex_destroy(&mutex);
+}
+
+void CallDispatcher::enqueue(Call* call) {
+  call->queued = uv_hrtime();
+  uv_mutex_lock(&mutex);
+  if (closed) {
+    // held calls are cancelled by the shutdown
+    bool held = call->held;
+    uv_mutex_unlock(&mutex);
+    if (!held) call->cancel();
+    return;
+  }
+  queue.push_back(call);
+  uv_mutex_unlock(&mutex);
+  // sends are coalesced until the JavaScript thread drains the queue
+  uv_async_send(&async);
+}
+
+void CallDispatcher::attach(Call* call) {
+  uv_mutex_lock(&mutex);
+  attached.insert(call);
+  uv_mutex_unlock(&mutex);
+}
+
+void CallDispatcher::detach(Call* call) {
+  uv_mutex_lock(&mutex);
+  attached.erase(call);
+  uv_mutex_unlock(&mutex);
+}
+
+void CallDispatcher::hold(Call* call) {
+  uv_mutex_lock(&mutex);
+  call->held = true;
+  working.insert(call);
+  bool first = working.size() == 1;
+  uv_mutex_unlock(&mutex);
+  if (first) uv_ref((uv_handle_t*) &async);
+}
+
+void CallDispatcher::release(Call* call) {
+  uv_mutex_lock(&mutex);
+  working.erase(call);
+  // the handle is closing once shut down
+  bool last = working.empty() && !closed;
+  uv_mutex_unlock(&mutex);
+  if (last) uv_unref((uv_handle_t*) &async);
+}
+
+void CallDispatcher::shutdown() {
+  /*
+   * This is invoked from the JavaScript thread
+   * while the environment is torn down.
+   */
+  std::vector<Call*> calls, held;
+  uv_mutex_lock(&mutex);
+  closed = true;
+  for (Call* call : queue) {
+    // queued callbacks are attached too (cancel them once)
+    if (!call->callback && !call->held) calls.push_back(call);
+  }
+  queue.clear();
+  calls.insert(calls.end(), attached.begin(), attached.end());
+  held.assign(working.begin(), working.end());
+  uv_mutex_unlock(&mutex);
+
+  for (Call* call : calls) {
+    call->cancel();
+  }
+
+  // no compile thread waits for JavaScript anymore, stop all
+  // pending work before waiting for any of it
+  for (Call* call : held) {
+    call->stop();
+  }
+  for (Call* call : held) {
+    call->cancel();
+  }
+
+  uv_close((uv_handle_t*) &async, async_gone);
+}
+
+CallDispatcher::stats CallDispatcher::get_stats() {
+  uv_mutex_lock(&mutex);
+  stats copy = counters;
+  uv_mutex_unlock(&mutex);
+  return copy;
+}
+
+void CallDispatcher::async_gone(uv_handle_t* handle) {
+  // held calls were cancelled after their compile threads were
+  // done, no thread can use the dispatcher anymore
+  delete static_cast<CallDispatcher*>(handle->data);
+}
+
+void CallDispatcher::dispatched_async_uv_callback(uv_async_t* req) {
+  CallDispatcher* dispatcher = static_cast<CallDispatcher*>(req->data);
+
+  /*
+   * Function called in the JavaScript thread.
+   * Runs all calls queued since the last turn.
+   */
+  std::vector<Call*> calls;
+  uv_mutex_lock(&dispatcher->mutex);
+  calls.swap(dispatcher->queue);
+  uv_mutex_unlock(&dispatcher->mutex);
+
+  if (calls.empty()) return;
+
+  uint64_t now = uv_hrtime();
+  uint64_t count = 0, latency = 0, max_latency = 0;
+  for (Call* call : calls) {
+    if (!call->callback) continue;
+    uint64_t waited = now - call->queued;
+    count += 1;
+    latency += waited;
+    if (waited > max_latency) max_latency = waited;
+  }
+
+  if (count > 0) {
+    uv_mutex_lock(&dispatcher->mutex);
+    dispatcher->counters.calls += count;
+    dispatcher->counters.round_trips += 1;
+    dispatcher->counters.latency += latency;
+    if (max_latency > dispatcher->counters.max_latency) {
+      dispatcher->counters.max_latency = max_latency;
+    }
+    uv_mutex_unlock(&dispatcher->mutex);
+  }
+
+  // one scope for the whole batch (at most one callback per render)
+  Nan::HandleScope scope;
+  for (Call* call : calls) {
+    call->dispatch();
+  }
+}
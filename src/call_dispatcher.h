@@ -0,0 +1,91 @@
+#ifndef CALL_DISPATCHER_H
+#define CALL_DISPATCHER_H
+
+#include <vector>
+#include <unordered_set>
+#include <stdint.h>
+#include <uv.h>
+
+// Hands work from compile threads to the JavaScript thread of one
+// environment (the main thread or a worker). JavaScript callbacks and
+// finished renders of the environment share a single async handle on
+// its loop; every call queued meanwhile is run in the same turn of the
+// loop, instead of waking the loop once per call and per bridge. A
+// compile thread waits for each of its callbacks, so a turn runs at
+// most one callback per concurrent render.
+class CallDispatcher {
+  public:
+    // A call waiting for the JavaScript thread
+    class Call {
+      public:
+        // callbacks are counted in the stats, other calls are not
+        Call(bool callback = false) : callback(callback), held(false) {}
+        virtual ~Call() {}
+        // run the call (on the JavaScript thread, in a handle scope)
+        virtual void dispatch() = 0;
+        // the environment shuts down and the call will never be
+        // dispatched (may be called on any thread, held calls are
+        // cancelled on the JavaScript thread)
+        virtual void cancel() = 0;
+        // the environment shuts down, end the pending work early
+        // (held calls, before any of them is cancelled)
+        virtual void stop() {}
+      private:
+        friend class CallDispatcher;
+        uint64_t queued;
+        bool callback;
+        bool held;
+    };
+
+    // Counters since the environment started
+    struct stats {
+      // callbacks dispatched
+      uint64_t calls;
+      // loop turns spent on dispatching callbacks
+      uint64_t round_trips;
+      // nanoseconds callbacks were queued (summed and the longest)
+      uint64_t latency;
+      uint64_t max_latency;
+    };
+
+    // Created on the JavaScript thread of the loop
+    explicit CallDispatcher(uv_loop_t*);
+
+    // Queue a call (called on a compile thread)
+    void enqueue(Call*);
+
+    // Callbacks also cancelled on shutdown when they are not queued,
+    // i.e. while they wait for JavaScript to answer
+    void attach(Call*);
+    void detach(Call*);
+
+    // Keep the loop alive while the work of a call is pending
+    // (JavaScript thread). On shutdown held calls are cancelled
+    // after all others, so they may wait for their compile threads;
+    // queueing them afterwards does nothing.
+    void hold(Call*);
+    void release(Call*);
+
+    // Cancel all calls and close the handle; the dispatcher is
+    // deleted once the handle is closed
+    void shutdown();
+
+    stats get_stats();
+
+  private:
+    ~CallDispatcher();
+
+    // Guards the fields below
+    uv_mutex_t mutex;
+    std::vector<Call*> queue;
+    std::unordered_set<Call*> attached;
+    std::unordered_set<Call*> working;
+    stats counters;
+    bool closed;
+    uv_async_t async;
+
+    static void dispatched_async_uv_callback(uv_async_t*);
+    static void async_gone(uv_handle_t*);
+};
+
+#endif
@@ -5,31 +5,36 @@
 #include <nan.h>
 #include <algorithm>
 #include <uv.h>
+#include "addon_data.h"
+#include "compile_pool.h"
+#include "call_dispatcher.h"
 
 #define COMMA ,
 
 template <typename T, typename L = void*>
-class CallbackBridge {
+class CallbackBridge : public CallDispatcher::Call {
   public:
     CallbackBridge(v8::Local<v8::Function>, bool);
     virtual ~CallbackBridge();
 
     // Executes the callback
-    T operator()(std::vector<void*>);
+    T operator()(const std::vector<void*>&);
 
   protected:
     // We will expose a bridge object to the JS callback that wraps this instance so we don't loose context.
     // This is the V8 constructor for such objects.
     static Nan::MaybeLocal<v8::Function> get_wrapper_constructor();
-    static void async_gone(uv_handle_t *handle);
     static NAN_METHOD(New);
     static NAN_METHOD(ReturnCallback);
-    static Nan::Persistent<v8::Function> wrapper_constructor;
     Nan::Persistent<v8::Object> wrapper;
 
-    // The callback that will get called in the main thread after the worker thread used for the sass
-    // compilation step makes a call to uv_async_send()
-    static void dispatched_async_uv_callback(uv_async_t*);
+    // The callback that will get called in the main thread after the compile thread
+    // queued the call on the dispatcher (calls of all renders are batched there)
+    void dispatch();
+
+    // Called when the environment shuts down, the callback will never return.
+    // Resumes the compile thread with the value below (now and for later calls).
+    void cancel();
 
     // The V8 values sent to our ReturnCallback must be read on the main thread not the sass worker thread.
     // This gives a chance to specialized subclasses to transform those values into whatever makes sense to
@@ -37,25 +42,28 @@ class CallbackBridge {
     virtual T post_process_return_value(v8::Local<v8::Value>) const =0;
 
 
-    virtual std::vector<v8::Local<v8::Value>> pre_process_args(std::vector<L>) const =0;
+    virtual std::vector<v8::Local<v8::Value>> pre_process_args(const std::vector<L>&) const =0;
+
+    // The value returned to sass after the bridge was cancelled. Built on the
+    // compile thread (no V8 available).
+    virtual T cancelled_return_value() const =0;
 
     Nan::Callback* callback;
+    CallDispatcher* dispatcher;
     Nan::AsyncResource* async_resource;
     bool is_sync;
 
     uv_mutex_t cv_mutex;
     uv_cond_t condition_variable;
-    uv_async_t *async;
+    // reused for every call (keeps its capacity)
     std::vector<L> argv;
     bool has_returned;
+    bool cancelled;
     T return_value;
 };
 
 template <typename T, typename L>
-Nan::Persistent<v8::Function> CallbackBridge<T, L>::wrapper_constructor;
-
-template <typename T, typename L>
-CallbackBridge<T, L>::CallbackBridge(v8::Local<v8::Function> callback, bool is_sync) : callback(new Nan::Callback(callback)), is_sync(is_sync) {
+CallbackBridge<T, L>::CallbackBridge(v8::Local<v8::Function> callback, bool is_sync) : CallDispatcher::Call(true), callback(new Nan::Callback(callback)), dispatcher(0), is_sync(is_sync), cancelled(false) {
   /*
    * This is invoked from the main JavaScript thread.
    * V8 context is available.
@@ -64,9 +72,9 @@ CallbackBridge<T, L>::CallbackBridge(v8::Local<v8::Function> callback, bool is_s
   uv_mutex_init(&this->cv_mutex);
   uv_cond_init(&this->condition_variable);
   if (!is_sync) {
-    this->async = new uv_async_t;
-    this->async->data = (void*) this;
-    uv_async_init(uv_default_loop(), this->async, (uv_async_cb) dispatched_async_uv_callback);
+    // calls go to the loop of the environment creating the bridge
+    this->dispatcher = AddonData::current()->dispatcher;
+    this->dispatcher->attach(this);
     this->async_resource = new Nan::AsyncResource("node-sass:CallbackBridge");
   }
 
@@ -83,13 +91,13 @@ CallbackBridge<T, L>::~CallbackBridge() {
   uv_mutex_destroy(&this->cv_mutex);
 
   if (!is_sync) {
-    uv_close((uv_handle_t*)this->async, &async_gone);
+    this->dispatcher->detach(this);
     delete this->async_resource;
   }
 }
 
 template <typename T, typename L>
-T CallbackBridge<T, L>::operator()(std::vector<void*> argv) {
+T CallbackBridge<T, L>::operator()(const std::vector<void*>& argv) {
   // argv.push_back(wrapper);
   if (this->is_sync) {
     /*
@@ -114,7 +122,7 @@ T CallbackBridge<T, L>::operator()(std::vector<void*> argv) {
     );
   } else {
     /*
-     * This is invoked from the worker thread.
+     * This is invoked from a compile thread.
      * No V8 context and functions available.
      * Just wait for response from asynchronously
      * scheduled JavaScript code
@@ -122,47 +130,71 @@ T CallbackBridge<T, L>::operator()(std::vector<void*> argv) {
      * XXX Issue #1048: We block here even if the
      *     event loop stops and the callback
      *     would never be executed.
-     * XXX Issue #857: By waiting here we occupy
-     *     one of the threads taken from the
-     *     uv threadpool. Might deadlock if
-     *     async I/O executed from JavaScript callbacks.
+     *
+     * While waiting the compile thread is parked,
+     * so the pool may start compiling other renders
+     * (see CompilePool). No libuv pool thread is
+     * occupied, async I/O from JavaScript callbacks
+     * can not deadlock anymore (Issue #857).
+     *
+     * If the environment (i.e. a worker thread)
+     * exits meanwhile, the call is cancelled.
      */
     this->argv = argv;
 
+    CompilePool::blocking_begin();
     uv_mutex_lock(&this->cv_mutex);
     this->has_returned = false;
-    uv_async_send(this->async);
-    while (!this->has_returned) {
-      uv_cond_wait(&this->condition_variable, &this->cv_mutex);
+    if (!this->cancelled) {
+      // a closed dispatcher cancels right away (takes the lock)
+      uv_mutex_unlock(&this->cv_mutex);
+      this->dispatcher->enqueue(this);
+      uv_mutex_lock(&this->cv_mutex);
+      while (!this->has_returned && !this->cancelled) {
+        uv_cond_wait(&this->condition_variable, &this->cv_mutex);
+      }
     }
+    bool has_returned = this->has_returned;
     uv_mutex_unlock(&this->cv_mutex);
-    return this->return_value;
+    CompilePool::blocking_end();
+    return has_returned ? this->return_value : this->cancelled_return_value();
   }
 }
 
 template <typename T, typename L>
-void CallbackBridge<T, L>::dispatched_async_uv_callback(uv_async_t *req) {
-  CallbackBridge* bridge = static_cast<CallbackBridge*>(req->data);
+void CallbackBridge<T, L>::cancel() {
+  /*
+   * Invoked from the main JavaScript thread on
+   * shutdown, or from a compile thread queuing
+   * a call afterwards.
+   */
+  uv_mutex_lock(&this->cv_mutex);
+  this->cancelled = true;
+  uv_mutex_unlock(&this->cv_mutex);
 
+  uv_cond_broadcast(&this->condition_variable);
+}
+
+template <typename T, typename L>
+void CallbackBridge<T, L>::dispatch() {
   /*
-   * Function scheduled via uv_async mechanism, therefore
+   * Function scheduled via the call dispatcher, therefore
    * it is invoked from the main JavaScript thread.
    * V8 context is available.
    *
-   * Establish Local<> scope for all functions
-   * from types invoked by pre_process_args() and
-   * post_process_args().
+   * The dispatcher establishes the Local<> scope
+   * for all functions from types invoked by
+   * pre_process_args() and post_process_args().
    */
-  Nan::HandleScope scope;
   Nan::TryCatch try_catch;
 
-  std::vector<v8::Local<v8::Value>> argv_v8 = bridge->pre_process_args(bridge->argv);
+  std::vector<v8::Local<v8::Value>> argv_v8 = this->pre_process_args(this->argv);
   if (try_catch.HasCaught()) {
     Nan::FatalException(try_catch);
   }
-  argv_v8.push_back(Nan::New(bridge->wrapper));
+  argv_v8.push_back(Nan::New(this->wrapper));
 
-  bridge->callback->Call(argv_v8.size(), &argv_v8[0], bridge->async_resource);
+  this->callback->Call(argv_v8.size(), &argv_v8[0], this->async_resource);
 
   if (try_catch.HasCaught()) {
     Nan::FatalException(try_catch);
@@ -200,6 +232,7 @@ NAN_METHOD(CallbackBridge<T COMMA L>::ReturnCallback) {
 template <typename T, typename L>
 Nan::MaybeLocal<v8::Function> CallbackBridge<T, L>::get_wrapper_constructor() {
   /* Uses handle scope created in the CallbackBridge<T, L> constructor */
+  Nan::Persistent<v8::Function>& wrapper_constructor = AddonData::current()->constructor<CallbackBridge<T, L>>();
   if (wrapper_constructor.IsEmpty()) {
     v8::Local<v8::FunctionTemplate> tpl = Nan::New<v8::FunctionTemplate>(New);
     tpl->SetClassName(Nan::New("CallbackBridge").ToLocalChecked());
@@ -220,9 +253,4 @@ NAN_METHOD(CallbackBridge<T COMMA L>::New) {
   info.GetReturnValue().Set(info.This());
 }
 
-template <typename T, typename L>
-void CallbackBridge<T, L>::async_gone(uv_handle_t *handle) {
-  delete (uv_async_t *)handle;
-}
-
 #endif
@@ -0,0 +1,215 @@
+#include "compile_pool.h"
+
+// Pool owning the current thread (null on other threads)
+static thread_local CompilePool* current = 0;
+
+class CompilePool::Completion : public CallDispatcher::Call {
+  public:
+    Completion(CompilePool::done_cb done, CompilePool::task_cb stop, CompilePool::task_cb abandon,
+               void* data, CallDispatcher* dispatcher)
+      : done(done), end(stop), abandon(abandon), data(data), dispatcher(dispatcher), error(0), finished(false) {
+      uv_mutex_init(&mutex);
+      uv_cond_init(&cond);
+      dispatcher->hold(this);
+    }
+
+    ~Completion() {
+      uv_cond_destroy(&cond);
+      uv_mutex_destroy(&mutex);
+    }
+
+    // called on the compile thread (or by submit
+    // with the error if the work can not run)
+    void enqueue(int status = 0) {
+      uv_mutex_lock(&mutex);
+      error = status;
+      dispatcher->enqueue(this);
+      // the call may be deleted once unlocked
+      finished = true;
+      uv_cond_signal(&cond);
+      uv_mutex_unlock(&mutex);
+    }
+
+    void dispatch() {
+      // the compile thread may not have unlocked yet
+      wait();
+      done(data, error);
+      dispatcher->release(this);
+      delete this;
+    }
+
+    void stop() {
+      end(data);
+    }
+
+    void cancel() {
+      /*
+       * The environment exits (called on its JavaScript thread
+       * after the work was stopped). Nothing can take the result;
+       * wait for the compile thread to let go of the data, so it
+       * is freed while V8 is still around.
+       */
+      wait();
+      abandon(data);
+      dispatcher->release(this);
+      delete this;
+    }
+
+  private:
+    CompilePool::done_cb done;
+    CompilePool::task_cb end;
+    CompilePool::task_cb abandon;
+    void* data;
+    CallDispatcher* dispatcher;
+    int error;
+
+    // Guards `finished`
+    uv_mutex_t mutex;
+    uv_cond_t cond;
+    bool finished;
+
+    // until the compile thread is done with the call
+    void wait() {
+      uv_mutex_lock(&mutex);
+      while (!finished) uv_cond_wait(&cond, &mutex);
+      uv_mutex_unlock(&mutex);
+    }
+};
+
+static size_t count_cores() {
+  uv_cpu_info_t* cpus;
+  int count = 0;
+  if (uv_cpu_info(&cpus, &count) == 0) {
+    uv_free_cpu_info(cpus, count);
+  }
+  return count > 0 ? static_cast<size_t>(count) : 1;
+}
+
+CompilePool& CompilePool::instance() {
+  // lives as long as the process (never deleted)
+  static CompilePool* pool = new CompilePool();
+  return *pool;
+}
+
+CompilePool::CompilePool()
+  : active(0), parked(0), idle(0), target(count_cores()) {
+  uv_mutex_init(&mutex);
+  uv_cond_init(&cond);
+}
+
+void CompilePool::submit(CallDispatcher* dispatcher, task_cb work, done_cb done,
+                         task_cb stop, task_cb abandon, void* data) {
+  // keeps the loop of the environment alive until delivered
+  task t = { work, data, new Completion(done, stop, abandon, data, dispatcher) };
+  std::deque<task> failed;
+
+  uv_mutex_lock(&mutex);
+  queue.push_back(t);
+  int status = maybe_spawn();
+  // no thread would ever take the queued work
+  if (status != 0 && threads.empty()) failed.swap(queue);
+  uv_mutex_unlock(&mutex);
+
+  for (task& f : failed) {
+    f.completion->enqueue(status);
+  }
+}
+
+// called with the mutex held
+int CompilePool::maybe_spawn() {
+  if (queue.empty()) return 0;
+  if (idle > 0) {
+    uv_cond_signal(&cond);
+    return 0;
+  }
+  // threads that did not pick up work yet are not counted
+  // as active, but they will (do not start too many)
+  if (threads.size() - parked >= target) return 0;
+  // they released the mutex for good, so this returns soon
+  for (uv_thread_t& thread : exited) {
+    uv_thread_join(&thread);
+  }
+  exited.clear();
+  uv_thread_t thread;
+  int status = uv_thread_create(&thread, work, this);
+  if (status == 0) {
+    threads.push_back(thread);
+  }
+  return status;
+}
+
+void CompilePool::park() {
+  uv_mutex_lock(&mutex);
+  --active;
+  ++parked;
+  // our core is free for queued renders
+  maybe_spawn();
+  uv_mutex_unlock(&mutex);
+}
+
+void CompilePool::unpark() {
+  uv_mutex_lock(&mutex);
+  --parked;
+  // may exceed the target for a while, threads
+  // only pick up new work once below it again
+  ++active;
+  uv_mutex_unlock(&mutex);
+}
+
+// called with the mutex held on the exiting thread
+void CompilePool::retire() {
+  uv_thread_t self = uv_thread_self();
+  for (size_t i = 0; i < threads.size(); ++i) {
+    if (uv_thread_equal(&threads[i], &self)) {
+      exited.push_back(threads[i]);
+      threads.erase(threads.begin() + i);
+      break;
+    }
+  }
+}
+
+void CompilePool::blocking_begin() {
+  if (current) current->park();
+}
+
+void CompilePool::blocking_end() {
+  if (current) current->unpark();
+}
+
+void CompilePool::work(void* arg) {
+  /*
+   * This is invoked from a compile thread.
+   * No V8 context and functions available.
+   */
+  CompilePool* pool = static_cast<CompilePool*>(arg);
+  current = pool;
+
+  uv_mutex_lock(&pool->mutex);
+  for (;;) {
+    while (pool->queue.empty() || pool->active >= pool->target) {
+      // started while others were parked, no longer needed
+      if (pool->threads.size() > pool->target) {
+        pool->retire();
+        uv_mutex_unlock(&pool->mutex);
+        return;
+      }
+      ++pool->idle;
+      uv_cond_wait(&pool->cond, &pool->mutex);
+      --pool->idle;
+    }
+    task t = pool->queue.front();
+    pool->queue.pop_front();
+    ++pool->active;
+    uv_mutex_unlock(&pool->mutex);
+
+    t.work(t.data);
+
+    // delivered with the callbacks of the same loop turn
+    t.completion->enqueue();
+
+    uv_mutex_lock(&pool->mutex);
+    --pool->active;
+    // a thread may wait for a free slot
+    if (!pool->queue.empty()) uv_cond_signal(&pool->cond);
+  }
+}
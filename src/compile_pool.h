@@ -0,0 +1,82 @@
+#ifndef COMPILE_POOL_H
+#define COMPILE_POOL_H
+
+#include <deque>
+#include <vector>
+#include <uv.h>
+#include "call_dispatcher.h"
+
+// Runs asynchronous renders on threads of its own instead of the
+// libuv thread pool. A render waiting for a JavaScript callback
+// (custom function or importer) blocks its compile thread; it then
+// reports itself as parked and the pool starts another thread for
+// queued renders if needed. So async I/O done in an importer (which
+// needs the libuv pool) can not deadlock and slow importers do not
+// hold back other renders. At most one thread per core compiles at
+// any time. Parked threads and up to one thread per core are kept for
+// later renders, threads beyond that exit once they run out of work.
+// The pool is shared by all environments (main thread and workers),
+// finished renders are handed back through the dispatcher of the
+// environment that submitted them.
+class CompilePool {
+  public:
+    typedef void (*task_cb)(void*);
+    // called with 0, or the error of the failed thread start
+    typedef void (*done_cb)(void*, int);
+
+    // The pool of the process (created on first use)
+    static CompilePool& instance();
+
+    // Queues `work` for a compile thread, `done` is called through
+    // the dispatcher afterwards (called on its JavaScript thread).
+    // If no compile thread runs and none can be started, `work` is
+    // skipped and `done` gets the error of uv_thread_create.
+    // If the environment exits first, `stop` is called to end the
+    // work early and `abandon` once it ended (both on the
+    // JavaScript thread while the environment is torn down).
+    void submit(CallDispatcher* dispatcher, task_cb work, done_cb done,
+                task_cb stop, task_cb abandon, void* data);
+
+    // Called around waiting for JavaScript (no-op if
+    // not called on a compile thread of the pool)
+    static void blocking_begin();
+    static void blocking_end();
+
+  private:
+    // Runs the done callback of a finished task
+    class Completion;
+
+    struct task {
+      task_cb work;
+      void* data;
+      Completion* completion;
+    };
+
+    CompilePool();
+
+    // Guards the fields below
+    uv_mutex_t mutex;
+    uv_cond_t cond;
+    std::deque<task> queue;
+    std::vector<uv_thread_t> threads;
+    // exited threads, joined when the next one starts
+    std::vector<uv_thread_t> exited;
+    // threads compiling right now (at most `target`)
+    size_t active;
+    // threads waiting for JavaScript
+    size_t parked;
+    // threads waiting for work
+    size_t idle;
+    size_t target;
+
+    // start a thread if none can take the queued work
+    // (returns the error if starting it failed)
+    int maybe_spawn();
+    void park();
+    void unpark();
+    void retire();
+
+    static void work(void*);
+};
+
+#endif
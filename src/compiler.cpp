@@ -0,0 +1,223 @@
+#include <nan.h>
+#include <stdlib.h>
+#include "addon_data.h"
+#include "compiler.h"
+#include "create_string.h"
+#include "sass_context_wrapper.h"
+
+static std::string get_string(v8::Local<v8::Object> options, const char* name) {
+  char* str = create_string(Nan::Get(options, Nan::New(name).ToLocalChecked()));
+  std::string rv(str ? str : "");
+  free(str);
+  return rv;
+}
+
+static int32_t get_int(v8::Local<v8::Object> options, const char* name) {
+  return Nan::To<int32_t>(Nan::Get(options, Nan::New(name).ToLocalChecked()).ToLocalChecked()).FromJust();
+}
+
+static uint32_t get_uint(v8::Local<v8::Object> options, const char* name) {
+  return Nan::To<uint32_t>(Nan::Get(options, Nan::New(name).ToLocalChecked()).ToLocalChecked()).FromJust();
+}
+
+static bool get_bool(v8::Local<v8::Object> options, const char* name) {
+  return Nan::To<bool>(Nan::Get(options, Nan::New(name).ToLocalChecked()).ToLocalChecked()).FromJust();
+}
+
+static const char* c_str_or_null(const std::string& str) {
+  return str.empty() ? 0 : str.c_str();
+}
+
+static void get_callbacks(v8::Local<v8::Object> options, const char* name, std::vector<Nan::Callback*>& callbacks) {
+  v8::Local<v8::Value> value = Nan::Get(options, Nan::New(name).ToLocalChecked()).ToLocalChecked();
+  if (!value->IsArray()) return;
+  v8::Local<v8::Array> array = value.As<v8::Array>();
+  for (uint32_t i = 0; i < array->Length(); ++i) {
+    callbacks.push_back(new Nan::Callback(Nan::Get(array, i).ToLocalChecked().As<v8::Function>()));
+  }
+}
+
+v8::Local<v8::Object> Compiler::create(v8::Local<v8::Object> options, struct Sass_Session* session, struct Sass_File_Cache* file_cache) {
+  Nan::EscapableHandleScope scope;
+
+  Nan::Persistent<v8::Function>& constructor = AddonData::current()->constructor<Compiler>();
+  if (constructor.IsEmpty()) {
+    v8::Local<v8::FunctionTemplate> tpl = Nan::New<v8::FunctionTemplate>(New);
+    tpl->SetClassName(Nan::New("SassCompiler").ToLocalChecked());
+    tpl->InstanceTemplate()->SetInternalFieldCount(1);
+    constructor.Reset(Nan::GetFunction(tpl).ToLocalChecked());
+  }
+
+  v8::Local<v8::Object> handle = Nan::NewInstance(Nan::New(constructor)).ToLocalChecked();
+  Compiler* compiler = new Compiler(options, session, file_cache);
+  compiler->Wrap(handle);
+  return scope.Escape(handle);
+}
+
+Compiler* Compiler::unwrap(v8::Local<v8::Value> handle) {
+  return Nan::ObjectWrap::Unwrap<Compiler>(handle.As<v8::Object>());
+}
+
+NAN_METHOD(Compiler::New) {
+  info.GetReturnValue().Set(info.This());
+}
+
+Compiler::Compiler(v8::Local<v8::Object> options, struct Sass_Session* session, struct Sass_File_Cache* file_cache)
+  : session(session), file_cache(file_cache), function_cache(0) {
+  /*
+   * This is invoked from the main JavaScript thread.
+   * V8 context is available.
+   */
+  include_path = get_string(options, "includePaths");
+  out_file = get_string(options, "outFile");
+  source_map = get_string(options, "sourceMap");
+  source_map_root = get_string(options, "sourceMapRoot");
+  linefeed = get_string(options, "linefeed");
+  indent = std::string(get_int(options, "indentWidth"), get_int(options, "indentType") == 1 ? '\t' : ' ');
+  style = get_int(options, "style");
+  precision = get_int(options, "precision");
+  indented_syntax = get_bool(options, "indentedSyntax");
+  source_comments = get_bool(options, "sourceComments");
+  omit_source_map_url = get_bool(options, "omitSourceMapUrl");
+  source_map_embed = get_bool(options, "sourceMapEmbed");
+  source_map_contents = get_bool(options, "sourceMapContents");
+  import_threads = get_int(options, "importThreads");
+  mmap_sources = get_bool(options, "mmapSources");
+  timeout = get_uint(options, "timeout");
+  // other compilers may register other functions under the same signatures
+  if (get_bool(options, "functionCache")) function_cache = sass_make_function_cache();
+
+  get_callbacks(options, "importer", importers);
+  get_callbacks(options, "importerSync", importers_sync);
+
+  v8::Local<v8::Value> custom_functions = Nan::Get(options, Nan::New("functions").ToLocalChecked()).ToLocalChecked();
+  v8::Local<v8::Value> custom_functions_sync = Nan::Get(options, Nan::New("functionsSync").ToLocalChecked()).ToLocalChecked();
+
+  if (custom_functions->IsObject() && custom_functions_sync->IsObject()) {
+    v8::Local<v8::Object> async = custom_functions.As<v8::Object>();
+    v8::Local<v8::Object> sync = custom_functions_sync.As<v8::Object>();
+    v8::Local<v8::Array> names = Nan::GetOwnPropertyNames(async).ToLocalChecked();
+
+    for (uint32_t i = 0; i < names->Length(); ++i) {
+      v8::Local<v8::Value> signature = Nan::Get(names, i).ToLocalChecked();
+      v8::Local<v8::Function> callback = Nan::Get(async, signature).ToLocalChecked().As<v8::Function>();
+
+      char* sig = create_string(signature);
+      signatures.push_back(sig);
+      free(sig);
+      pure.push_back(Nan::To<bool>(Nan::Get(callback, Nan::New("pure").ToLocalChecked()).ToLocalChecked()).FromJust());
+      functions.push_back(new Nan::Callback(callback));
+      functions_sync.push_back(new Nan::Callback(Nan::Get(sync, signature).ToLocalChecked().As<v8::Function>()));
+    }
+  }
+}
+
+Compiler::~Compiler() {
+  for (bridge_set& bridges : idle) delete_bridges(bridges);
+  for (bridge_set& bridges : idle_sync) delete_bridges(bridges);
+  for (Nan::Callback* callback : functions) delete callback;
+  for (Nan::Callback* callback : functions_sync) delete callback;
+  for (Nan::Callback* callback : importers) delete callback;
+  for (Nan::Callback* callback : importers_sync) delete callback;
+  // kept alive by the contexts of running renders
+  sass_delete_function_cache(function_cache);
+}
+
+Compiler::bridge_set Compiler::make_bridges(bool is_sync) const {
+  const std::vector<Nan::Callback*>& function_callbacks = is_sync ? functions_sync : functions;
+  const std::vector<Nan::Callback*>& importer_callbacks = is_sync ? importers_sync : importers;
+  bridge_set bridges;
+
+  for (Nan::Callback* callback : function_callbacks) {
+    bridges.functions.push_back(new CustomFunctionBridge(callback->GetFunction(), is_sync));
+  }
+  for (Nan::Callback* callback : importer_callbacks) {
+    bridges.importers.push_back(new CustomImporterBridge(callback->GetFunction(), is_sync));
+  }
+  return bridges;
+}
+
+void Compiler::delete_bridges(bridge_set& bridges) {
+  for (CustomFunctionBridge* bridge : bridges.functions) delete bridge;
+  for (CustomImporterBridge* bridge : bridges.importers) delete bridge;
+  bridges.functions.clear();
+  bridges.importers.clear();
+}
+
+void Compiler::start(Sass_Options* sass_options, sass_context_wrapper* ctx_w) {
+  /*
+   * This is invoked from the main JavaScript thread.
+   * V8 context is available.
+   */
+  sass_option_set_output_path(sass_options, c_str_or_null(out_file));
+  sass_option_set_output_style(sass_options, (Sass_Output_Style) style);
+  sass_option_set_is_indented_syntax_src(sass_options, indented_syntax);
+  sass_option_set_source_comments(sass_options, source_comments);
+  sass_option_set_omit_source_map_url(sass_options, omit_source_map_url);
+  sass_option_set_source_map_embed(sass_options, source_map_embed);
+  sass_option_set_source_map_contents(sass_options, source_map_contents);
+  sass_option_set_import_threads(sass_options, import_threads);
+  sass_option_set_mmap_sources(sass_options, mmap_sources);
+  sass_option_set_timeout(sass_options, timeout);
+  sass_option_set_source_map_file(sass_options, c_str_or_null(source_map));
+  sass_option_set_source_map_root(sass_options, c_str_or_null(source_map_root));
+  sass_option_set_include_path(sass_options, c_str_or_null(include_path));
+  sass_option_set_precision(sass_options, precision);
+  sass_option_set_indent(sass_options, indent.c_str());
+  sass_option_set_linefeed(sass_options, c_str_or_null(linefeed));
+  if (session) sass_option_set_session(sass_options, session);
+  if (file_cache) sass_option_set_file_cache(sass_options, file_cache);
+  if (function_cache) sass_option_set_function_cache(sass_options, function_cache);
+
+  // reuse the bridges of a finished render
+  std::vector<bridge_set>& sets = ctx_w->is_sync ? idle_sync : idle;
+  bridge_set bridges;
+  if (sets.empty()) {
+    bridges = make_bridges(ctx_w->is_sync);
+  }
+  else {
+    bridges = sets.back();
+    sets.pop_back();
+  }
+  ctx_w->function_bridges.swap(bridges.functions);
+  ctx_w->importer_bridges.swap(bridges.importers);
+
+  // the lists are owned by the context (built for every render)
+  if (!ctx_w->importer_bridges.empty()) {
+    size_t count = ctx_w->importer_bridges.size();
+    Sass_Importer_List c_importers = sass_make_importer_list(count);
+    for (size_t i = 0; i < count; ++i) {
+      c_importers[i] = sass_make_importer(sass_importer, count - i - 1, ctx_w->importer_bridges[i]);
+    }
+    sass_option_set_c_importers(sass_options, c_importers);
+  }
+
+  if (!ctx_w->function_bridges.empty()) {
+    size_t count = ctx_w->function_bridges.size();
+    Sass_Function_List fn_list = sass_make_function_list(count);
+    for (size_t i = 0; i < count; ++i) {
+      Sass_Function_Entry fn = sass_make_function(signatures[i].c_str(), sass_custom_function, ctx_w->function_bridges[i]);
+      sass_function_set_pure(fn, pure[i]);
+      sass_function_set_list_entry(fn_list, i, fn);
+    }
+    sass_option_set_c_functions(sass_options, fn_list);
+  }
+
+  // the settings must outlive the render
+  ctx_w->compiler = this;
+  Ref();
+}
+
+void Compiler::finish(sass_context_wrapper* ctx_w) {
+  /*
+   * This is invoked from the main JavaScript thread
+   * while the context wrapper is freed.
+   */
+  bridge_set bridges;
+  bridges.functions.swap(ctx_w->function_bridges);
+  bridges.importers.swap(ctx_w->importer_bridges);
+  (ctx_w->is_sync ? idle_sync : idle).push_back(bridges);
+
+  ctx_w->compiler = 0;
+  Unref();
+}
@@ -0,0 +1,80 @@
+#ifndef COMPILER_H
+#define COMPILER_H
+
+#include <string>
+#include <vector>
+#include <nan.h>
+#include <sass/context.h>
+#include "custom_function_bridge.h"
+#include "custom_importer_bridge.h"
+
+struct sass_context_wrapper;
+
+// Options of many renders extracted once, for renders where only the
+// input changes. The settings, callbacks and bridges are kept by the
+// handle returned to JavaScript; a render borrows a set of bridges
+// (one set per concurrent render) and gives it back when its context
+// wrapper is freed. The handle is kept alive while renders are running.
+class Compiler : public Nan::ObjectWrap {
+  public:
+    // Wraps a new compiler (called on the JavaScript thread)
+    static v8::Local<v8::Object> create(v8::Local<v8::Object>, struct Sass_Session*, struct Sass_File_Cache*);
+    static Compiler* unwrap(v8::Local<v8::Value>);
+
+    // Applies the options to the context of a render
+    void start(Sass_Options*, sass_context_wrapper*);
+    // Takes back the bridges of a finished render
+    void finish(sass_context_wrapper*);
+
+  private:
+    Compiler(v8::Local<v8::Object>, struct Sass_Session*, struct Sass_File_Cache*);
+    ~Compiler();
+
+    // Bridges used by one render at a time
+    struct bridge_set {
+      std::vector<CustomFunctionBridge*> functions;
+      std::vector<CustomImporterBridge*> importers;
+    };
+
+    // Settings shared by all renders
+    std::string include_path;
+    std::string out_file;
+    std::string source_map;
+    std::string source_map_root;
+    std::string linefeed;
+    std::string indent;
+    int style;
+    int precision;
+    int import_threads;
+    size_t timeout;
+    bool indented_syntax;
+    bool source_comments;
+    bool omit_source_map_url;
+    bool source_map_embed;
+    bool source_map_contents;
+    bool mmap_sources;
+    struct Sass_Session* session;
+    struct Sass_File_Cache* file_cache;
+    // results of its pure functions (with functionCache)
+    struct Sass_Function_Cache* function_cache;
+
+    // Custom functions and importers, wrapped for
+    // async and for sync renders (same order)
+    std::vector<std::string> signatures;
+    std::vector<bool> pure;
+    std::vector<Nan::Callback*> functions;
+    std::vector<Nan::Callback*> functions_sync;
+    std::vector<Nan::Callback*> importers;
+    std::vector<Nan::Callback*> importers_sync;
+
+    // Bridges of finished renders
+    std::vector<bridge_set> idle;
+    std::vector<bridge_set> idle_sync;
+
+    bridge_set make_bridges(bool is_sync) const;
+    static void delete_bridges(bridge_set&);
+
+    static NAN_METHOD(New);
+};
+
+#endif
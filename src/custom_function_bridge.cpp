@@ -4,6 +4,19 @@
 #include "sass_types/factory.h"
 #include "sass_types/value.h"
 
+union Sass_Value* sass_custom_function(const union Sass_Value* s_args, Sass_Function_Entry cb, struct Sass_Compiler* comp)
+{
+  void* cookie = sass_function_get_cookie(cb);
+  CustomFunctionBridge& bridge = *(static_cast<CustomFunctionBridge*>(cookie));
+
+  std::vector<void*> argv;
+  for (unsigned l = sass_list_get_length(s_args), i = 0; i < l; i++) {
+    argv.push_back((void*)sass_list_get_value(s_args, i));
+  }
+
+  return bridge(argv);
+}
+
 Sass_Value* CustomFunctionBridge::post_process_return_value(v8::Local<v8::Value> _val) const {
   SassTypes::Value *value = SassTypes::Factory::unwrap(_val);
   if (value) {
@@ -13,7 +26,7 @@ Sass_Value* CustomFunctionBridge::post_process_return_value(v8::Local<v8::Value>
   }
 }
 
-std::vector<v8::Local<v8::Value>> CustomFunctionBridge::pre_process_args(std::vector<void*> in) const {
+std::vector<v8::Local<v8::Value>> CustomFunctionBridge::pre_process_args(const std::vector<void*>& in) const {
   std::vector<v8::Local<v8::Value>> argv = std::vector<v8::Local<v8::Value>>();
 
   for (void* value : in) {
@@ -25,3 +38,7 @@ std::vector<v8::Local<v8::Value>> CustomFunctionBridge::pre_process_args(std::ve
 
   return argv;
 }
+
+Sass_Value* CustomFunctionBridge::cancelled_return_value() const {
+  return sass_make_error("The environment exited before the function returned.");
+}
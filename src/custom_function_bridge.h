@@ -6,13 +6,17 @@
 #include <sass/functions.h>
 #include "callback_bridge.h"
 
+// Function of libsass calling the bridge given as its cookie
+union Sass_Value* sass_custom_function(const union Sass_Value* s_args, Sass_Function_Entry cb, struct Sass_Compiler* comp);
+
 class CustomFunctionBridge : public CallbackBridge<Sass_Value*> {
   public:
     CustomFunctionBridge(v8::Local<v8::Function> cb, bool is_sync) : CallbackBridge<Sass_Value*>(cb, is_sync) {}
 
   private:
     Sass_Value* post_process_return_value(v8::Local<v8::Value>) const;
-    std::vector<v8::Local<v8::Value>> pre_process_args(std::vector<void*>) const;
+    std::vector<v8::Local<v8::Value>> pre_process_args(const std::vector<void*>&) const;
+    Sass_Value* cancelled_return_value() const;
 };
 
 #endif
@@ -1,8 +1,23 @@
 #include <nan.h>
 #include <stdexcept>
+#include <sass/context.h>
 #include "custom_importer_bridge.h"
 #include "create_string.h"
 
+Sass_Import_List sass_importer(const char* cur_path, Sass_Importer_Entry cb, struct Sass_Compiler* comp)
+{
+  void* cookie = sass_importer_get_cookie(cb);
+  struct Sass_Import* previous = sass_compiler_get_last_import(comp);
+  const char* prev_path = sass_import_get_abs_path(previous);
+  CustomImporterBridge& bridge = *(static_cast<CustomImporterBridge*>(cookie));
+
+  std::vector<void*> argv;
+  argv.push_back((void*)cur_path);
+  argv.push_back((void*)prev_path);
+
+  return bridge(argv);
+}
+
 SassImportList CustomImporterBridge::post_process_return_value(v8::Local<v8::Value> returned_value) const {
   SassImportList imports = 0;
   Nan::HandleScope scope;
@@ -92,7 +107,7 @@ Sass_Import* CustomImporterBridge::get_importer_entry(const v8::Local<v8::Object
   return sass_make_import_entry(path, contents, srcmap);
 }
 
-std::vector<v8::Local<v8::Value>> CustomImporterBridge::pre_process_args(std::vector<void*> in) const {
+std::vector<v8::Local<v8::Value>> CustomImporterBridge::pre_process_args(const std::vector<void*>& in) const {
   std::vector<v8::Local<v8::Value>> out;
 
   for (void* ptr : in) {
@@ -101,3 +116,12 @@ std::vector<v8::Local<v8::Value>> CustomImporterBridge::pre_process_args(std::ve
 
   return out;
 }
+
+SassImportList CustomImporterBridge::cancelled_return_value() const {
+  SassImportList imports = sass_make_import_list(1);
+
+  imports[0] = sass_make_import_entry(0, 0, 0);
+  sass_import_set_error(imports[0], "The environment exited before the importer returned.", -1, -1);
+
+  return imports;
+}
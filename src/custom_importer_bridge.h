@@ -8,6 +8,9 @@
 
 typedef Sass_Import_List SassImportList;
 
+// Importer of libsass calling the bridge given as its cookie
+Sass_Import_List sass_importer(const char* cur_path, Sass_Importer_Entry cb, struct Sass_Compiler* comp);
+
 class CustomImporterBridge : public CallbackBridge<SassImportList> {
   public:
     CustomImporterBridge(v8::Local<v8::Function> cb, bool is_sync) : CallbackBridge<SassImportList>(cb, is_sync) {}
@@ -16,7 +19,8 @@ class CustomImporterBridge : public CallbackBridge<SassImportList> {
     SassImportList post_process_return_value(v8::Local<v8::Value>) const;
     Sass_Import* check_returned_string(Nan::MaybeLocal<v8::Value> value, const char *msg) const;
     Sass_Import* get_importer_entry(const v8::Local<v8::Object>&) const;
-    std::vector<v8::Local<v8::Value>> pre_process_args(std::vector<void*>) const;
+    std::vector<v8::Local<v8::Value>> pre_process_args(const std::vector<void*>&) const;
+    SassImportList cancelled_return_value() const;
 };
 
 #endif
@@ -14,6 +14,7 @@
         'libsass/src/ast.cpp',
         'libsass/src/ast_fwd_decl.cpp',
         'libsass/src/backtrace.cpp',
+        'libsass/src/budget.cpp',
         'libsass/src/base64vlq.cpp',
         'libsass/src/bind.cpp',
         'libsass/src/cencode.c',
@@ -29,6 +30,8 @@
         'libsass/src/expand.cpp',
         'libsass/src/extend.cpp',
         'libsass/src/file.cpp',
+        'libsass/src/file_cache.cpp',
+        'libsass/src/function_cache.cpp',
         'libsass/src/functions.cpp',
         'libsass/src/inspect.cpp',
         'libsass/src/json.cpp',
@@ -50,6 +53,10 @@
         'libsass/src/sass_functions.cpp',
         'libsass/src/sass_util.cpp',
         'libsass/src/sass_values.cpp',
+        'libsass/src/value_pool.cpp',
+        'libsass/src/sheet_cache.cpp',
+        'libsass/src/session.cpp',
+        'libsass/src/prefetcher.cpp',
         'libsass/src/source_map.cpp',
         'libsass/src/subset_map.cpp',
         'libsass/src/to_c.cpp',
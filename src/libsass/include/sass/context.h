@@ -21,6 +21,15 @@ struct Sass_Context; // : Sass_Options
 struct Sass_File_Context; // : Sass_Context
 struct Sass_Data_Context; // : Sass_Context
 
+// Forward declaration
+struct Sass_Sheet_Cache; // shared parsed stylesheets
+struct Sass_Session; // incremental compiler session
+struct Sass_File_Cache; // directory listings for imports
+struct Sass_Function_Cache; // results of pure custom functions
+
+// Receives a chunk of the css output (not null terminated)
+typedef void (*Sass_Output_Sink) (const char* chunk, size_t length, void* cookie);
+
 // Compiler states
 enum Sass_Compiler_State {
   SASS_COMPILER_CREATED,
@@ -28,6 +37,18 @@ enum Sass_Compiler_State {
   SASS_COMPILER_EXECUTED
 };
 
+// Compiler phases (for profiling)
+enum Sass_Compiler_Phase {
+  SASS_PHASE_PARSE,
+  SASS_PHASE_EXPAND,
+  SASS_PHASE_CHECK_NESTING,
+  SASS_PHASE_CSSIZE,
+  SASS_PHASE_EXTEND,
+  SASS_PHASE_REMOVE_PLACEHOLDERS,
+  SASS_PHASE_OUTPUT,
+  SASS_PHASE_SOURCE_MAP
+};
+
 // Create and initialize an option struct
 ADDAPI struct Sass_Options* ADDCALL sass_make_options (void);
 // Create and initialize a specific context
@@ -47,6 +68,10 @@ ADDAPI struct Sass_Compiler* ADDCALL sass_make_data_compiler (struct Sass_Data_C
 ADDAPI int ADDCALL sass_compiler_parse(struct Sass_Compiler* compiler);
 ADDAPI int ADDCALL sass_compiler_execute(struct Sass_Compiler* compiler);
 
+// Stop a running compilation at its next loop iteration (may be called
+// from any thread while the compiler exists); it fails with an error
+ADDAPI void ADDCALL sass_compiler_cancel(struct Sass_Compiler* compiler);
+
 // Release all memory allocated with the compiler
 // This does _not_ include any contexts or options
 ADDAPI void ADDCALL sass_delete_compiler(struct Sass_Compiler* compiler);
@@ -77,6 +102,10 @@ ADDAPI bool ADDCALL sass_option_get_source_map_contents (struct Sass_Options* op
 ADDAPI bool ADDCALL sass_option_get_source_map_file_urls (struct Sass_Options* options);
 ADDAPI bool ADDCALL sass_option_get_omit_source_map_url (struct Sass_Options* options);
 ADDAPI bool ADDCALL sass_option_get_is_indented_syntax_src (struct Sass_Options* options);
+ADDAPI int ADDCALL sass_option_get_import_threads (struct Sass_Options* options);
+ADDAPI bool ADDCALL sass_option_get_mmap_sources (struct Sass_Options* options);
+ADDAPI size_t ADDCALL sass_option_get_timeout (struct Sass_Options* options);
+ADDAPI size_t ADDCALL sass_option_get_max_steps (struct Sass_Options* options);
 ADDAPI const char* ADDCALL sass_option_get_indent (struct Sass_Options* options);
 ADDAPI const char* ADDCALL sass_option_get_linefeed (struct Sass_Options* options);
 ADDAPI const char* ADDCALL sass_option_get_input_path (struct Sass_Options* options);
@@ -96,6 +125,10 @@ ADDAPI void ADDCALL sass_option_set_source_map_contents (struct Sass_Options* op
 ADDAPI void ADDCALL sass_option_set_source_map_file_urls (struct Sass_Options* options, bool source_map_file_urls);
 ADDAPI void ADDCALL sass_option_set_omit_source_map_url (struct Sass_Options* options, bool omit_source_map_url);
 ADDAPI void ADDCALL sass_option_set_is_indented_syntax_src (struct Sass_Options* options, bool is_indented_syntax_src);
+ADDAPI void ADDCALL sass_option_set_import_threads (struct Sass_Options* options, int import_threads);
+ADDAPI void ADDCALL sass_option_set_mmap_sources (struct Sass_Options* options, bool mmap_sources);
+ADDAPI void ADDCALL sass_option_set_timeout (struct Sass_Options* options, size_t timeout);
+ADDAPI void ADDCALL sass_option_set_max_steps (struct Sass_Options* options, size_t max_steps);
 ADDAPI void ADDCALL sass_option_set_indent (struct Sass_Options* options, const char* indent);
 ADDAPI void ADDCALL sass_option_set_linefeed (struct Sass_Options* options, const char* linefeed);
 ADDAPI void ADDCALL sass_option_set_input_path (struct Sass_Options* options, const char* input_path);
@@ -107,6 +140,16 @@ ADDAPI void ADDCALL sass_option_set_source_map_root (struct Sass_Options* option
 ADDAPI void ADDCALL sass_option_set_c_headers (struct Sass_Options* options, Sass_Importer_List c_headers);
 ADDAPI void ADDCALL sass_option_set_c_importers (struct Sass_Options* options, Sass_Importer_List c_importers);
 ADDAPI void ADDCALL sass_option_set_c_functions (struct Sass_Options* options, Sass_Function_List c_functions);
+ADDAPI void ADDCALL sass_option_set_sheet_cache (struct Sass_Options* options, struct Sass_Sheet_Cache* sheet_cache);
+ADDAPI struct Sass_Sheet_Cache* ADDCALL sass_option_get_sheet_cache (struct Sass_Options* options);
+ADDAPI void ADDCALL sass_option_set_session (struct Sass_Options* options, struct Sass_Session* session);
+ADDAPI struct Sass_Session* ADDCALL sass_option_get_session (struct Sass_Options* options);
+ADDAPI void ADDCALL sass_option_set_file_cache (struct Sass_Options* options, struct Sass_File_Cache* file_cache);
+ADDAPI struct Sass_File_Cache* ADDCALL sass_option_get_file_cache (struct Sass_Options* options);
+ADDAPI void ADDCALL sass_option_set_function_cache (struct Sass_Options* options, struct Sass_Function_Cache* function_cache);
+ADDAPI struct Sass_Function_Cache* ADDCALL sass_option_get_function_cache (struct Sass_Options* options);
+ADDAPI void ADDCALL sass_option_set_output_sink (struct Sass_Options* options, Sass_Output_Sink output_sink, void* cookie);
+ADDAPI Sass_Output_Sink ADDCALL sass_option_get_output_sink (struct Sass_Options* options);
 
 
 // Getters for Sass_Context values
@@ -122,6 +165,19 @@ ADDAPI size_t ADDCALL sass_context_get_error_column (struct Sass_Context* ctx);
 ADDAPI const char* ADDCALL sass_context_get_source_map_string (struct Sass_Context* ctx);
 ADDAPI char** ADDCALL sass_context_get_included_files (struct Sass_Context* ctx);
 
+// Profiling of the last compilation (times are in milliseconds)
+ADDAPI const char* ADDCALL sass_compiler_phase_name (enum Sass_Compiler_Phase phase);
+ADDAPI double ADDCALL sass_context_get_phase_time (struct Sass_Context* ctx, enum Sass_Compiler_Phase phase);
+ADDAPI size_t ADDCALL sass_context_get_phase_allocations (struct Sass_Context* ctx, enum Sass_Compiler_Phase phase);
+ADDAPI size_t ADDCALL sass_context_get_function_calls (struct Sass_Context* ctx);
+ADDAPI double ADDCALL sass_context_get_function_time (struct Sass_Context* ctx);
+ADDAPI size_t ADDCALL sass_context_get_importer_calls (struct Sass_Context* ctx);
+ADDAPI double ADDCALL sass_context_get_importer_time (struct Sass_Context* ctx);
+ADDAPI size_t ADDCALL sass_context_get_lookahead_probes (struct Sass_Context* ctx);
+ADDAPI size_t ADDCALL sass_context_get_lookahead_hits (struct Sass_Context* ctx);
+ADDAPI size_t ADDCALL sass_context_get_lookahead_scanned (struct Sass_Context* ctx);
+ADDAPI size_t ADDCALL sass_context_get_lookahead_saved (struct Sass_Context* ctx);
+
 // Getters for options include path array
 ADDAPI size_t ADDCALL sass_option_get_include_path_size(struct Sass_Options* options);
 ADDAPI const char* ADDCALL sass_option_get_include_path(struct Sass_Options* options, size_t i);
@@ -149,6 +205,67 @@ ADDAPI size_t ADDCALL sass_compiler_get_callee_stack_size(struct Sass_Compiler*
 ADDAPI Sass_Callee_Entry ADDCALL sass_compiler_get_last_callee(struct Sass_Compiler* compiler);
 ADDAPI Sass_Callee_Entry ADDCALL sass_compiler_get_callee_entry(struct Sass_Compiler* compiler, size_t idx);
 
+// Create a cache for parsed stylesheets that can be shared by many
+// compilations (also across threads). Options hold a reference to it.
+ADDAPI struct Sass_Sheet_Cache* ADDCALL sass_make_sheet_cache (void);
+// Share and release references (last release frees all memory)
+ADDAPI struct Sass_Sheet_Cache* ADDCALL sass_sheet_cache_retain (struct Sass_Sheet_Cache* cache);
+ADDAPI void ADDCALL sass_delete_sheet_cache (struct Sass_Sheet_Cache* cache);
+// Drop cached sheets for one absolute path or for all paths
+ADDAPI void ADDCALL sass_sheet_cache_invalidate (struct Sass_Sheet_Cache* cache, const char* abs_path);
+ADDAPI void ADDCALL sass_sheet_cache_clear (struct Sass_Sheet_Cache* cache);
+// Getters for cache statistics
+ADDAPI size_t ADDCALL sass_sheet_cache_get_size (struct Sass_Sheet_Cache* cache);
+ADDAPI size_t ADDCALL sass_sheet_cache_get_hits (struct Sass_Sheet_Cache* cache);
+ADDAPI size_t ADDCALL sass_sheet_cache_get_misses (struct Sass_Sheet_Cache* cache);
+
+// Create a cache for directory listings used to resolve imports. Changes
+// on disk are not detected, changed paths must be invalidated explicitly.
+ADDAPI struct Sass_File_Cache* ADDCALL sass_make_file_cache (void);
+// Share and release references (last release frees all memory)
+ADDAPI struct Sass_File_Cache* ADDCALL sass_file_cache_retain (struct Sass_File_Cache* cache);
+ADDAPI void ADDCALL sass_delete_file_cache (struct Sass_File_Cache* cache);
+// Drop the listings of an absolute path and its directory, or all of them
+ADDAPI void ADDCALL sass_file_cache_invalidate (struct Sass_File_Cache* cache, const char* abs_path);
+ADDAPI void ADDCALL sass_file_cache_clear (struct Sass_File_Cache* cache);
+// Getters for cache statistics (hits are saved stat calls)
+ADDAPI size_t ADDCALL sass_file_cache_get_size (struct Sass_File_Cache* cache);
+ADDAPI size_t ADDCALL sass_file_cache_get_hits (struct Sass_File_Cache* cache);
+ADDAPI size_t ADDCALL sass_file_cache_get_misses (struct Sass_File_Cache* cache);
+
+// Create a cache for the results of pure custom functions, to share them
+// across compilations. All of them must register the same functions.
+ADDAPI struct Sass_Function_Cache* ADDCALL sass_make_function_cache (void);
+// Share and release references (last release frees all memory)
+ADDAPI struct Sass_Function_Cache* ADDCALL sass_function_cache_retain (struct Sass_Function_Cache* cache);
+ADDAPI void ADDCALL sass_delete_function_cache (struct Sass_Function_Cache* cache);
+// Drop all results (i.e. after the functions changed)
+ADDAPI void ADDCALL sass_function_cache_clear (struct Sass_Function_Cache* cache);
+// Getters for cache statistics (hits are calls that were not made)
+ADDAPI size_t ADDCALL sass_function_cache_get_size (struct Sass_Function_Cache* cache);
+ADDAPI size_t ADDCALL sass_function_cache_get_hits (struct Sass_Function_Cache* cache);
+ADDAPI size_t ADDCALL sass_function_cache_get_misses (struct Sass_Function_Cache* cache);
+
+// Create a session that records the import graph of all entry files compiled
+// with it and reuses their parsed stylesheets. Options hold a reference to it.
+ADDAPI struct Sass_Session* ADDCALL sass_make_session (void);
+// Share and release references (last release frees all memory)
+ADDAPI struct Sass_Session* ADDCALL sass_session_retain (struct Sass_Session* session);
+ADDAPI void ADDCALL sass_delete_session (struct Sass_Session* session);
+// The sheet cache owned by the session (no new reference)
+ADDAPI struct Sass_Sheet_Cache* ADDCALL sass_session_get_sheet_cache (struct Sass_Session* session);
+// The file cache owned by the session, invalidated by file changes (no new reference)
+ADDAPI struct Sass_File_Cache* ADDCALL sass_session_get_file_cache (struct Sass_Session* session);
+// Report a changed, added or removed file; returns the entry files to recompile
+ADDAPI char** ADDCALL sass_session_file_changed (struct Sass_Session* session, const char* abs_path);
+// All files the given file imports (recursively)
+ADDAPI char** ADDCALL sass_session_get_dependencies (struct Sass_Session* session, const char* abs_path);
+// All entry files compiled with the session and how to drop one of them
+ADDAPI char** ADDCALL sass_session_get_entries (struct Sass_Session* session);
+ADDAPI void ADDCALL sass_session_forget_entry (struct Sass_Session* session, const char* abs_path);
+// Free a null terminated list returned by the functions above
+ADDAPI void ADDCALL sass_delete_string_list (char** list);
+
 // Push function for paths (no manipulation support for now)
 ADDAPI void ADDCALL sass_option_push_plugin_path (struct Sass_Options* options, const char* path);
 ADDAPI void ADDCALL sass_option_push_include_path (struct Sass_Options* options, const char* path);
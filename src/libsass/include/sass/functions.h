@@ -131,6 +131,11 @@ ADDAPI const char* ADDCALL sass_function_get_signature (Sass_Function_Entry cb);
 ADDAPI Sass_Function_Fn ADDCALL sass_function_get_function (Sass_Function_Entry cb);
 ADDAPI void* ADDCALL sass_function_get_cookie (Sass_Function_Entry cb);
 
+// Pure functions always return the same value for the same arguments,
+// so their results are reused (per compilation or via a function cache)
+ADDAPI void ADDCALL sass_function_set_pure (Sass_Function_Entry cb, bool pure);
+ADDAPI bool ADDCALL sass_function_get_pure (Sass_Function_Entry cb);
+
 
 #ifdef __cplusplus
 } // __cplusplus defined.
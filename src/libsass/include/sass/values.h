@@ -12,6 +12,7 @@ extern "C" {
 
 // Forward declaration
 union Sass_Value;
+struct Sass_Value_Pool;
 
 // Type for Sass values
 enum Sass_Tag {
@@ -138,6 +139,18 @@ ADDAPI void ADDCALL sass_error_set_message (union Sass_Value* v, char* msg);
 ADDAPI char* ADDCALL sass_warning_get_message (const union Sass_Value* v);
 ADDAPI void ADDCALL sass_warning_set_message (union Sass_Value* v, char* msg);
 
+// Pools recycle the memory of values made and deleted on one thread
+// Compiles use their own pool while they run (no setup needed)
+ADDAPI struct Sass_Value_Pool* ADDCALL sass_make_value_pool (void);
+// Frees all recycled memory (values made from it stay valid)
+ADDAPI void ADDCALL sass_delete_value_pool (struct Sass_Value_Pool* pool);
+// Values made and deleted on the calling thread use the pool until it
+// is left again (pools must be left in the reverse order of entering)
+ADDAPI void ADDCALL sass_value_pool_enter (struct Sass_Value_Pool* pool);
+ADDAPI void ADDCALL sass_value_pool_leave (struct Sass_Value_Pool* pool);
+// Frees the recycled memory now
+ADDAPI void ADDCALL sass_value_pool_clear (struct Sass_Value_Pool* pool);
+
 #ifdef __cplusplus
 } // __cplusplus defined.
 #endif
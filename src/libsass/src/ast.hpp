@@ -1466,32 +1466,41 @@ namespace Sass {
   // Function calls.
   //////////////////
   class Function_Call : public PreValue {
-    HASH_CONSTREF(std::string, name)
     HASH_PROPERTY(Arguments_Obj, arguments)
     HASH_PROPERTY(Function_Obj, func)
     ADD_PROPERTY(bool, via_call)
     ADD_PROPERTY(void*, cookie)
     size_t hash_;
+    std::string name_;
+    // key of the function in the environment
+    EnvKey key_;
   public:
     Function_Call(ParserState pstate, std::string n, Arguments_Obj args, void* cookie)
-    : PreValue(pstate), name_(n), arguments_(args), func_(0), via_call_(false), cookie_(cookie), hash_(0)
+    : PreValue(pstate), arguments_(args), func_(0), via_call_(false), cookie_(cookie), hash_(0), name_(n), key_(env_key(n))
     { concrete_type(FUNCTION); }
     Function_Call(ParserState pstate, std::string n, Arguments_Obj args, Function_Obj func)
-    : PreValue(pstate), name_(n), arguments_(args), func_(func), via_call_(false), cookie_(0), hash_(0)
+    : PreValue(pstate), arguments_(args), func_(func), via_call_(false), cookie_(0), hash_(0), name_(n), key_(env_key(n))
     { concrete_type(FUNCTION); }
     Function_Call(ParserState pstate, std::string n, Arguments_Obj args)
-    : PreValue(pstate), name_(n), arguments_(args), via_call_(false), cookie_(0), hash_(0)
+    : PreValue(pstate), arguments_(args), via_call_(false), cookie_(0), hash_(0), name_(n), key_(env_key(n))
     { concrete_type(FUNCTION); }
     Function_Call(const Function_Call* ptr)
     : PreValue(ptr),
-      name_(ptr->name_),
       arguments_(ptr->arguments_),
       func_(ptr->func_),
       via_call_(ptr->via_call_),
       cookie_(ptr->cookie_),
-      hash_(ptr->hash_)
+      hash_(ptr->hash_),
+      name_(ptr->name_),
+      key_(ptr->key_)
     { concrete_type(FUNCTION); }
 
+    const std::string& name() const { return name_; }
+    void name(const std::string& n) { hash_ = 0; name_ = n; key_ = env_key(n); }
+    const EnvKey& key() const { return key_; }
+    static EnvKey env_key(const std::string& name)
+    { return EnvKey(Util::normalize_underscores(name) + "[f]"); }
+
     bool is_css() {
       if (func_) return func_->is_css();
       return false;
@@ -1551,15 +1560,21 @@ namespace Sass {
   // Variable references.
   ///////////////////////
   class Variable : public PreValue {
-    ADD_CONSTREF(std::string, name)
+    std::string name_;
+    // key of the variable in the environment
+    EnvKey key_;
   public:
     Variable(ParserState pstate, std::string n)
-    : PreValue(pstate), name_(n)
+    : PreValue(pstate), name_(n), key_(n)
     { concrete_type(VARIABLE); }
     Variable(const Variable* ptr)
-    : PreValue(ptr), name_(ptr->name_)
+    : PreValue(ptr), name_(ptr->name_), key_(ptr->key_)
     { concrete_type(VARIABLE); }
 
+    const std::string& name() const { return name_; }
+    void name(const std::string& n) { name_ = n; key_ = EnvKey(n); }
+    const EnvKey& key() const { return key_; }
+
     virtual bool operator==(const Expression& rhs) const
     {
       try
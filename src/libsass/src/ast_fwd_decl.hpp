@@ -422,7 +422,8 @@ namespace Sass {
   typedef std::vector<Sass_Import_Entry>* ImporterStack;
 
   // only to switch implementations for testing
-  #define environment_map std::map
+  // (keys must be hashable, see EnvKey and HashEnvKey)
+  #define environment_map std::unordered_map
 
   // ###########################################################################
   // explicit type conversion functions
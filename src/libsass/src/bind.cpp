@@ -295,6 +295,8 @@ namespace Sass {
         }
         else if (leftover->default_value()) {
           Expression_Ptr dv = leftover->default_value()->perform(eval);
+          // never hand out shared built-in defaults
+          if (dv->is_frozen()) dv = SASS_MEMORY_COPY(dv);
           env->local_frame()[leftover->name()] = dv;
         }
         else {
@@ -0,0 +1,43 @@
+#include "sass.hpp"
+#include <sstream>
+
+#include "ast.hpp"
+#include "budget.hpp"
+#include "error_handling.hpp"
+
+namespace Sass {
+
+  Budget::Budget()
+  : cancelled(false), deadline(), timeout_ms(0),
+    max_steps(0), steps(0), next_check(CLOCK_INTERVAL)
+  { }
+
+  void Budget::start(size_t timeout_ms, size_t max_steps)
+  {
+    this->timeout_ms = timeout_ms;
+    this->max_steps = max_steps;
+    deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout_ms);
+    steps = 0;
+    next_check = max_steps && max_steps < CLOCK_INTERVAL ? max_steps + 1 : CLOCK_INTERVAL;
+  }
+
+  void Budget::check(const ParserState& pstate, const Backtraces& traces)
+  {
+    if (is_cancelled()) {
+      throw Exception::Cancelled(pstate, traces, "compilation was cancelled");
+    }
+    if (max_steps && steps > max_steps) {
+      std::stringstream msg;
+      msg << "compilation stopped after " << max_steps << " steps";
+      throw Exception::Cancelled(pstate, traces, msg.str());
+    }
+    if (timeout_ms && std::chrono::steady_clock::now() >= deadline) {
+      std::stringstream msg;
+      msg << "compilation timed out after " << timeout_ms << "ms";
+      throw Exception::Cancelled(pstate, traces, msg.str());
+    }
+    next_check = steps + CLOCK_INTERVAL;
+    if (max_steps && next_check > max_steps) next_check = max_steps + 1;
+  }
+
+}
@@ -0,0 +1,47 @@
+#ifndef SASS_BUDGET_H
+#define SASS_BUDGET_H
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+
+#include "position.hpp"
+#include "backtrace.hpp"
+
+namespace Sass {
+
+  // Cooperative limits of one compile. Loops that may run for a long
+  // time (control directives and @extend) count their iterations as
+  // steps; a step throws once the compile was cancelled from another
+  // thread, ran out of time or used up its steps. The clock is only
+  // read every few hundred steps, so a step is cheap.
+  class Budget {
+    public:
+      Budget();
+      // start the clock (0 disables the limit)
+      void start(size_t timeout_ms, size_t max_steps);
+      // stop the compile at its next step (thread safe)
+      void cancel() { cancelled.store(true, std::memory_order_relaxed); }
+      bool is_cancelled() const { return cancelled.load(std::memory_order_relaxed); }
+      // count one step of the compile
+      void step(const ParserState& pstate, const Backtraces& traces)
+      {
+        if (++ steps >= next_check || is_cancelled()) check(pstate, traces);
+      }
+      size_t get_steps() const { return steps; }
+    private:
+      // steps between reading the clock
+      static const size_t CLOCK_INTERVAL = 256;
+      std::atomic<bool> cancelled;
+      std::chrono::steady_clock::time_point deadline;
+      size_t timeout_ms;
+      size_t max_steps;
+      size_t steps;
+      size_t next_check;
+      // throws if a limit was hit
+      void check(const ParserState& pstate, const Backtraces& traces);
+  };
+
+}
+
+#endif
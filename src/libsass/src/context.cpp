@@ -4,12 +4,15 @@
 #include <cstring>
 #include <iomanip>
 #include <sstream>
+#include <unordered_map>
 #include <iostream>
 
 #include "ast.hpp"
 #include "util.hpp"
 #include "sass.h"
 #include "context.hpp"
+#include "session.hpp"
+#include "prefetcher.hpp"
 #include "plugins.hpp"
 #include "constants.hpp"
 #include "parser.hpp"
@@ -71,10 +74,20 @@ namespace Sass {
     strings(),
     resources(),
     sheets(),
+    sheet_cache(c_options.sheet_cache ? c_options.sheet_cache->retain() :
+                c_options.session ? c_options.session->sheet_cache()->retain() :
+                c_options.import_threads > 0 ? new Sheet_Cache() : 0),
+    cached_sheets(),
+    prefetched_sheets(),
+    sheet_stack(),
+    file_cache(c_options.file_cache ? c_options.file_cache->retain() : 0),
+    function_cache(c_options.function_cache ? c_options.function_cache->retain() : new Function_Cache()),
+    sheet_env(),
     subset_map(),
     import_stack(),
     callee_stack(),
     traces(),
+    profile(),
     c_compiler(NULL),
 
     c_headers               (std::vector<Sass_Importer_Entry>()),
@@ -101,6 +114,10 @@ namespace Sass {
     collect_plugin_paths(c_options.plugin_path);
     collect_plugin_paths(c_options.plugin_paths);
 
+    // cached sheets are only valid for the same lookup paths
+    sheet_env = CWD;
+    for (auto path : include_paths) sheet_env += PATH_SEP + path;
+
     // load plugins and register custom behaviors
     for(auto plug : plugin_paths) plugins.load_plugins(plug);
     for(auto fn : plugins.get_headers()) c_headers.push_back(fn);
@@ -113,6 +130,9 @@ namespace Sass {
 
     emitter.set_filename(abs2rel(output_path, source_map_file, CWD));
 
+    // the timeout includes loading the sources
+    budget.start(c_options.timeout, c_options.max_steps);
+
   }
 
   void Context::add_c_function(Sass_Function_Entry function)
@@ -134,9 +154,11 @@ namespace Sass {
 
   Context::~Context()
   {
+    // buffers of cached sheets are owned by the cache
+    for (auto lease : cached_sheets) resources[lease.first].contents = 0;
     // resources were allocated by malloc
     for (size_t i = 0; i < resources.size(); ++i) {
-      free(resources[i].contents);
+      free_file(resources[i].contents);
       free(resources[i].srcmap);
     }
     // free all strings we kept alive during compiler execution
@@ -151,6 +173,15 @@ namespace Sass {
     // clear inner structures (vectors) and input source
     resources.clear(); import_stack.clear();
     subset_map.clear(), sheets.clear();
+    // drop all references into cached trees
+    // before other threads may lease them
+    ast_gc.clear();
+    for (auto lease : cached_sheets) sheet_cache->release(lease.second);
+    for (auto lease : prefetched_sheets) sheet_cache->release(lease.second);
+    cached_sheets.clear(); prefetched_sheets.clear();
+    if (sheet_cache && sheet_cache->release()) delete sheet_cache;
+    if (file_cache && file_cache->release()) delete file_cache;
+    if (function_cache->release()) delete function_cache;
   }
 
   Data_Context::~Data_Context()
@@ -239,12 +270,12 @@ namespace Sass {
     // make sure we resolve against an absolute path
     std::string base_path(rel2abs(import.base_path));
     // first try to resolve the load path relative to the base path
-    std::vector<Include> vec(resolve_includes(base_path, import.imp_path));
+    std::vector<Include> vec(resolve_includes(base_path, import.imp_path, defaultExtensions, file_cache));
     // then search in every include path (but only if nothing found yet)
     for (size_t i = 0, S = include_paths.size(); vec.size() == 0 && i < S; ++i)
     {
       // call resolve_includes and individual base path and append all results
-      std::vector<Include> resolved(resolve_includes(include_paths[i], import.imp_path));
+      std::vector<Include> resolved(resolve_includes(include_paths[i], import.imp_path, defaultExtensions, file_cache));
       if (resolved.size()) vec.insert(vec.end(), resolved.begin(), resolved.end());
     }
     // return vector
@@ -298,6 +329,39 @@ namespace Sass {
     ParserState pstate(strings.back(), contents, idx);
 
     // check existing import stack for possible recursion
+    check_import_loop(import, pstate);
+
+    // create a parser instance from the given c_str buffer
+    Parser p(Parser::from_c_str(contents, *this, traces, pstate));
+    // do not yet dispose these buffers
+    sass_import_take_source(import);
+    sass_import_take_srcmap(import);
+    // then parse the root block
+    Block_Obj root = p.parse();
+    p.memo.add_stats(profile.lookaheads);
+    // delete memory of current stack frame
+    sass_delete_import(import_stack.back());
+    // remove current stack frame
+    import_stack.pop_back();
+    // create key/value pair for ast node
+    std::pair<const std::string, StyleSheet>
+      ast_pair(inc.abs_path, { res, root });
+    // register resulting resource
+    sheets.insert(ast_pair);
+  }
+
+  // register include with resolved path and its content
+  // memory of the resources will be freed by us on exit
+  void Context::register_resource(const Include& inc, const Resource& res, ParserState& prstate)
+  {
+    traces.push_back(Backtrace(prstate));
+    register_resource(inc, res);
+    traces.pop_back();
+  }
+
+  // check existing import stack for possible recursion
+  void Context::check_import_loop(Sass_Import_Entry import, ParserState& pstate)
+  {
     for (size_t i = 0; i < import_stack.size() - 2; ++i) {
       auto parent = import_stack[i];
       if (std::strcmp(parent->abs_path, import->abs_path) == 0) {
@@ -314,31 +378,143 @@ namespace Sass {
         // error(stack, prstate ? *prstate : pstate, import_stack);
       }
     }
+  }
 
-    // create a parser instance from the given c_str buffer
-    Parser p(Parser::from_c_str(contents, *this, traces, pstate));
-    // do not yet dispose these buffers
+  // the sheet cache can only be used if nothing but the
+  // file system decides about the content of the sheets
+  // source maps need per context indexes in parser states
+  bool Context::use_sheet_cache()
+  {
+    return sheet_cache != 0 &&
+           c_headers.empty() &&
+           c_importers.empty() &&
+           source_map_file.empty() &&
+           !c_options.source_map_embed;
+  }
+
+  // lease a cached sheet if itself and all of its
+  // direct imports still resolve to the same files
+  Cached_Sheet* Context::acquire_sheet(const std::string& abs_path)
+  {
+    std::string cache_key(rel2abs(abs_path, ".", CWD));
+    Cached_Sheet* sheet = sheet_cache->acquire(cache_key, sheet_env);
+    if (sheet == 0) return 0;
+    for (const Cached_Import& imp : sheet->imports) {
+      const std::vector<Include> resolved(find_includes(imp.importer));
+      if (resolved.size() != 1 || resolved[0].abs_path != imp.include.abs_path) {
+        // a new partial shadows the old one (or it is gone)
+        sheet_cache->invalidate(cache_key);
+        sheet_cache->release(sheet);
+        return 0;
+      }
+    }
+    return sheet;
+  }
+
+  // load a file resource through the sheet cache
+  // returns false if the file could not be read
+  bool Context::load_sheet(const Include& inc, ParserState& pstate)
+  {
+    Cached_Sheet* sheet = 0;
+    // take the sheet parsed by the prefetcher
+    auto it = prefetched_sheets.find(inc.abs_path);
+    if (it != prefetched_sheets.end()) {
+      sheet = it->second;
+      prefetched_sheets.erase(it);
+    }
+    else {
+      sheet = acquire_sheet(inc.abs_path);
+    }
+    if (sheet == 0) {
+      // try to read the content of the resolved file entry
+      char* contents = read_file(inc.abs_path, c_options.mmap_sources);
+      if (contents == 0) return false;
+      // the cache takes over the buffer
+      sheet = sheet_cache->create(rel2abs(inc.abs_path, ".", CWD), inc.abs_path, sheet_env, contents);
+    }
+    register_sheet(inc, sheet, pstate);
+    return true;
+  }
+
+  // register a leased sheet, parsing it if it is new
+  // otherwise only the imports it depends on are loaded
+  void Context::register_sheet(const Include& inc, Cached_Sheet* sheet)
+  {
+
+    // get index for this resource
+    size_t idx = resources.size();
+
+    // returned to the cache on exit
+    cached_sheets.push_back(std::make_pair(idx, sheet));
+
+    // tell emitter about new resource
+    emitter.add_source_index(idx);
+
+    // borrow the buffers from the cache
+    resources.push_back({ sheet->contents, 0 });
+
+    // add a relative link to the working directory
+    included_files.push_back(inc.abs_path);
+    // add a relative link  to the source map output file
+    srcmap_links.push_back(abs2rel(inc.abs_path, source_map_file, CWD));
+
+    // get pointer to the loaded content
+    Sass_Import_Entry import = sass_make_import(
+      inc.imp_path.c_str(),
+      inc.abs_path.c_str(),
+      sheet->contents,
+      0
+    );
+    // add the entry to the stack
+    import_stack.push_back(import);
+
+    // parser states point into the cached buffers
+    ParserState pstate(sheet->path, sheet->contents, idx);
+
+    // check existing import stack for possible recursion
+    check_import_loop(import, pstate);
+
+    // do not dispose the cached buffers
     sass_import_take_source(import);
     sass_import_take_srcmap(import);
-    // then parse the root block
-    Block_Obj root = p.parse();
+
+    if (sheet->root.isNull()) {
+      // record the imports while parsing
+      sheet_stack.push_back(sheet);
+      // create a parser instance from the given c_str buffer
+      Parser p(Parser::from_c_str(sheet->contents, *this, traces, pstate));
+      // then parse the root block
+      sheet->root = p.parse();
+      p.memo.add_stats(profile.lookaheads);
+      sheet_stack.pop_back();
+    }
+    else {
+      // replay the imports the parser has resolved before
+      for (const Cached_Import& imp : sheet->imports) {
+        import_edges.push_back(std::make_pair(imp.importer, imp.include));
+        if (sheets.count(imp.include.abs_path)) continue;
+        ParserState imp_pstate(imp.pstate);
+        if (!load_sheet(imp.include, imp_pstate)) {
+          error("File to import not found or unreadable: " + imp.importer.imp_path + ".", imp_pstate, traces);
+        }
+      }
+    }
+
     // delete memory of current stack frame
     sass_delete_import(import_stack.back());
     // remove current stack frame
     import_stack.pop_back();
     // create key/value pair for ast node
     std::pair<const std::string, StyleSheet>
-      ast_pair(inc.abs_path, { res, root });
+      ast_pair(inc.abs_path, { resources[idx], sheet->root });
     // register resulting resource
     sheets.insert(ast_pair);
   }
 
-  // register include with resolved path and its content
-  // memory of the resources will be freed by us on exit
-  void Context::register_resource(const Include& inc, const Resource& res, ParserState& prstate)
+  void Context::register_sheet(const Include& inc, Cached_Sheet* sheet, ParserState& prstate)
   {
     traces.push_back(Backtrace(prstate));
-    register_resource(inc, res);
+    register_sheet(inc, sheet);
     traces.pop_back();
   }
 
@@ -367,9 +543,14 @@ namespace Sass {
       bool use_cache = c_importers.size() == 0;
       // use cache for the resource loading
       if (use_cache && sheets.count(resolved[0].abs_path)) return resolved[0];
+      // reuse sheets parsed by earlier compilations
+      if (use_sheet_cache()) {
+        if (load_sheet(resolved[0], pstate)) return resolved[0];
+        return { imp, "" };
+      }
       // try to read the content of the resolved file entry
       // the memory buffer returned must be freed by us!
-      if (char* contents = read_file(resolved[0].abs_path)) {
+      if (char* contents = read_file(resolved[0].abs_path, c_options.mmap_sources)) {
         // register the newly resolved file resource
         register_resource(resolved[0], { contents, 0 }, pstate);
         // return resolved entry
@@ -382,7 +563,9 @@ namespace Sass {
 
   }
 
-  void Context::import_url (Import_Ptr imp, std::string load_path, const std::string& ctx_path) {
+  // keep urls and css files as plain css imports
+  // returns false if the import must be resolved
+  bool Context::add_css_import(Import_Ptr imp, const std::string& load_path) {
 
     ParserState pstate(imp->pstate());
     std::string imp_path(unquote(load_path));
@@ -409,13 +592,29 @@ namespace Sass {
       imp->urls().push_back(new_url);
     }
     else {
-      const Importer importer(imp_path, ctx_path);
-      Include include(load_import(importer, pstate));
-      if (include.abs_path.empty()) {
-        error("File to import not found or unreadable: " + imp_path + ".", pstate, traces);
-      }
-      imp->incs().push_back(include);
+      return false;
+    }
+    return true;
+
+  }
+
+  void Context::import_url (Import_Ptr imp, std::string load_path, const std::string& ctx_path) {
+
+    if (add_css_import(imp, load_path)) return;
+
+    ParserState pstate(imp->pstate());
+    std::string imp_path(unquote(load_path));
+    const Importer importer(imp_path, ctx_path);
+    Include include(load_import(importer, pstate));
+    if (include.abs_path.empty()) {
+      error("File to import not found or unreadable: " + imp_path + ".", pstate, traces);
     }
+    import_edges.push_back(std::make_pair(importer, include));
+    // remember the import on the sheet being parsed
+    if (!sheet_stack.empty()) {
+      sheet_stack.back()->imports.push_back(Cached_Import(importer, include, pstate));
+    }
+    imp->incs().push_back(include);
 
   }
 
@@ -431,10 +630,13 @@ namespace Sass {
     for (Sass_Importer_Entry& importer_ent : importers) {
       // int priority = sass_importer_get_priority(importer);
       Sass_Importer_Fn fn = sass_importer_get_function(importer_ent);
+      Sass_Import_List includes = 0;
+      {
+        Callback_Timer timer(profile.importers);
+        includes = fn(load_path.c_str(), importer_ent, c_compiler);
+      }
       // skip importer if it returns NULL
-      if (Sass_Import_List includes =
-          fn(load_path.c_str(), importer_ent, c_compiler)
-      ) {
+      if (includes) {
         // get c pointer copy to iterate over
         Sass_Import_List it_includes = includes;
         while (*it_includes) { ++count;
@@ -500,10 +702,11 @@ namespace Sass {
     return has_import;
   }
 
-  void register_function(Context&, Signature sig, Native_Function f, Env* env);
-  void register_function(Context&, Signature sig, Native_Function f, size_t arity, Env* env);
-  void register_overload_stub(Context&, std::string name, Env* env);
-  void register_built_in_functions(Context&, Env* env);
+  typedef std::unordered_map<EnvKey, Definition_Obj, HashEnvKey> Built_In_Functions;
+  void register_function(Context&, Signature sig, Native_Function f, Built_In_Functions& fns);
+  void register_function(Context&, Signature sig, Native_Function f, size_t arity, Built_In_Functions& fns);
+  void register_overload_stub(Context&, std::string name, Built_In_Functions& fns);
+  void register_built_in_functions(Context&, Built_In_Functions& fns);
   void register_c_functions(Context&, Env* env, Sass_Function_List);
   void register_c_function(Context&, Env* env, Sass_Function_Entry);
 
@@ -511,12 +714,18 @@ namespace Sass {
   {
     // check for valid block
     if (!root) return 0;
+    Phase_Timer output(profile, SASS_PHASE_OUTPUT);
+    // write finished blocks to the sink
+    if (c_options.output_sink) {
+      emitter.stream_to(c_options.output_sink, c_options.output_sink_cookie, has_utf8_sources());
+    }
     // start the render process
     root->perform(&emitter);
     // finish emitter stream
     emitter.finalize();
     // get the resulting buffer from stream
     OutputBuffer emitted = emitter.get_buffer();
+    output.stop();
     // should we append a source map url?
     if (!c_options.omit_source_map_url) {
       // generate an embeded source map
@@ -530,11 +739,27 @@ namespace Sass {
         emitted.buffer += format_source_mapping_url(source_map_file);
       }
     }
+    // the sink takes the rest, the result stays empty
+    if (c_options.output_sink) {
+      c_options.output_sink(emitted.buffer.data(), emitted.buffer.size(), c_options.output_sink_cookie);
+      return sass_copy_c_string("");
+    }
     // create a copy of the resulting buffer string
     // this must be freed or taken over by implementor
     return sass_copy_c_string(emitted.buffer.c_str());
   }
 
+  bool Context::has_utf8_sources()
+  {
+    for (const Resource& res : resources) {
+      if (!res.contents) continue;
+      for (const char* chr = res.contents; *chr; ++chr) {
+        if (static_cast<unsigned char>(*chr) >= 128) return true;
+      }
+    }
+    return false;
+  }
+
   void Context::apply_custom_headers(Block_Obj root, const char* ctx_path, ParserState pstate)
   {
     // create a custom import to resolve headers
@@ -558,24 +783,42 @@ namespace Sass {
     // check if entry file is given
     if (input_path.empty()) return 0;
 
+    Phase_Timer parsing(profile, SASS_PHASE_PARSE);
+
     // create absolute path from input filename
     // ToDo: this should be resolved via custom importers
     std::string abs_path(rel2abs(input_path, CWD));
 
+    // maybe reuse the sheet from an earlier compilation
+    bool use_cache = use_sheet_cache();
+    Cached_Sheet* sheet = use_cache ? acquire_sheet(abs_path) : 0;
+
     // try to load the entry file
-    char* contents = read_file(abs_path);
+    char* contents = sheet ? 0 : read_file(abs_path, c_options.mmap_sources);
 
     // alternatively also look inside each include path folder
     // I think this differs from ruby sass (IMO too late to remove)
-    for (size_t i = 0, S = include_paths.size(); contents == 0 && i < S; ++i) {
+    for (size_t i = 0, S = include_paths.size(); contents == 0 && sheet == 0 && i < S; ++i) {
       // build absolute path for this include path entry
       abs_path = rel2abs(input_path, include_paths[i]);
-      // try to load the resulting path
-      contents = read_file(abs_path);
+      // try to reuse or load the resulting path
+      if (use_cache) sheet = acquire_sheet(abs_path);
+      if (sheet == 0) contents = read_file(abs_path, c_options.mmap_sources);
     }
 
     // abort early if no content could be loaded (various reasons)
-    if (!contents) throw std::runtime_error("File to read not found or unreadable: " + input_path);
+    if (!contents && !sheet) throw std::runtime_error("File to read not found or unreadable: " + input_path);
+
+    // the cache takes over the buffer
+    if (use_cache && sheet == 0) {
+      sheet = sheet_cache->create(abs_path, abs_path, sheet_env, contents);
+    }
+    if (sheet) contents = sheet->contents;
+
+    // parse the import tree on worker threads first
+    if (sheet && c_options.import_threads > 0) {
+      Prefetcher(*this, c_options.import_threads).run(sheet);
+    }
 
     // store entry path
     entry_path = abs_path;
@@ -591,7 +834,9 @@ namespace Sass {
     import_stack.push_back(import);
 
     // create the source entry for file entry
-    register_resource({{ input_path, "." }, abs_path }, { contents, 0 });
+    if (sheet) register_sheet({{ input_path, "." }, abs_path }, sheet);
+    else register_resource({{ input_path, "." }, abs_path }, { contents, 0 });
+    parsing.stop();
 
     // create root ast tree node
     return compile();
@@ -604,6 +849,8 @@ namespace Sass {
     // check if source string is given
     if (!source_c_str) return 0;
 
+    Phase_Timer parsing(profile, SASS_PHASE_PARSE);
+
     // convert indented sass syntax
     if(c_options.is_indented_syntax_src) {
       // call sass2scss to convert the string
@@ -634,6 +881,7 @@ namespace Sass {
 
     // register a synthetic resource (path does not really exist, skip in includes)
     register_resource({{ input_path, "." }, input_path }, { source_c_str, srcmap_c_str });
+    parsing.stop();
 
     // create root ast tree node
     return compile();
@@ -651,8 +899,7 @@ namespace Sass {
     // abort on invalid root
     if (root.isNull()) return 0;
     Env global; // create root environment
-    // register built-in functions on env
-    register_built_in_functions(*this, &global);
+    // built-in functions are looked up in a shared table
     // register custom functions (defined via C-API)
     for (size_t i = 0, S = c_functions.size(); i < S; ++i)
     { register_c_function(*this, &global, c_functions[i]); }
@@ -662,18 +909,31 @@ namespace Sass {
     Cssize cssize(*this);
     CheckNesting check_nesting;
     // check nesting in all files
-    for (auto sheet : sheets) {
-      auto styles = sheet.second;
-      check_nesting(styles.root);
+    {
+      Phase_Timer timer(profile, SASS_PHASE_CHECK_NESTING);
+      for (auto sheet : sheets) {
+        auto styles = sheet.second;
+        check_nesting(styles.root);
+      }
     }
     // expand and eval the tree
-    root = expand(root);
+    {
+      Phase_Timer timer(profile, SASS_PHASE_EXPAND);
+      root = expand(root);
+    }
     // check nesting
-    check_nesting(root);
+    {
+      Phase_Timer timer(profile, SASS_PHASE_CHECK_NESTING);
+      check_nesting(root);
+    }
     // merge and bubble certain rules
-    root = cssize(root);
+    {
+      Phase_Timer timer(profile, SASS_PHASE_CSSIZE);
+      root = cssize(root);
+    }
     // should we extend something?
     if (!subset_map.empty()) {
+      Phase_Timer timer(profile, SASS_PHASE_EXTEND);
       // create crtp visitor object
       Extend extend(subset_map);
       extend.setEval(expand.eval);
@@ -683,6 +943,7 @@ namespace Sass {
 
     // clean up by removing empty placeholders
     // ToDo: maybe we can do this somewhere else?
+    Phase_Timer timer(profile, SASS_PHASE_REMOVE_PLACEHOLDERS);
     Remove_Placeholders remove_placeholders;
     root->perform(&remove_placeholders);
     // return processed tree
@@ -692,6 +953,7 @@ namespace Sass {
 
   std::string Context::format_embedded_source_map()
   {
+    Phase_Timer timer(profile, SASS_PHASE_SOURCE_MAP);
     std::string map = emitter.render_srcmap(*this);
     std::istringstream is( map );
     std::ostringstream buffer;
@@ -711,6 +973,7 @@ namespace Sass {
   char* Context::render_srcmap()
   {
     if (source_map_file == "") return 0;
+    Phase_Timer timer(profile, SASS_PHASE_SOURCE_MAP);
     std::string map = emitter.render_srcmap(*this);
     return sass_copy_c_string(map.c_str());
   }
@@ -730,23 +993,42 @@ namespace Sass {
       return includes;
   }
 
-  void register_function(Context& ctx, Signature sig, Native_Function f, Env* env)
+  // built-in definitions are frozen, so they can be
+  // shared between contexts running on other threads
+  static void freeze_definition(Definition_Ptr def)
+  {
+    def->freeze();
+    if (Parameters_Ptr params = def->parameters()) {
+      params->freeze();
+      for (Parameter_Obj param : params->elements()) {
+        param->freeze();
+        if (Expression_Ptr value = param->default_value()) {
+          value->freeze();
+          if (Unary_Expression_Ptr unary = Cast<Unary_Expression>(value)) {
+            unary->operand()->freeze();
+          }
+        }
+      }
+    }
+  }
+
+  void register_function(Context& ctx, Signature sig, Native_Function f, Built_In_Functions& fns)
   {
     Definition_Ptr def = make_native_function(sig, f, ctx);
-    def->environment(env);
-    (*env)[def->name() + "[f]"] = def;
+    freeze_definition(def);
+    fns[def->name() + "[f]"] = def;
   }
 
-  void register_function(Context& ctx, Signature sig, Native_Function f, size_t arity, Env* env)
+  void register_function(Context& ctx, Signature sig, Native_Function f, size_t arity, Built_In_Functions& fns)
   {
     Definition_Ptr def = make_native_function(sig, f, ctx);
     std::stringstream ss;
     ss << def->name() << "[f]" << arity;
-    def->environment(env);
-    (*env)[ss.str()] = def;
+    freeze_definition(def);
+    fns[ss.str()] = def;
   }
 
-  void register_overload_stub(Context& ctx, std::string name, Env* env)
+  void register_overload_stub(Context& ctx, std::string name, Built_In_Functions& fns)
   {
     Definition_Ptr stub = SASS_MEMORY_NEW(Definition,
                                        ParserState("[built-in function]"),
@@ -755,112 +1037,128 @@ namespace Sass {
                                        0,
                                        0,
                                        true);
-    (*env)[name + "[f]"] = stub;
+    freeze_definition(stub);
+    fns[name + "[f]"] = stub;
+  }
+
+  static Built_In_Functions make_built_in_functions(Context& ctx)
+  {
+    Built_In_Functions fns;
+    register_built_in_functions(ctx, fns);
+    return fns;
   }
 
+  // the table is created by the first context that needs it
+  // and is never modified afterwards (initialization is thread-safe)
+  Definition_Ptr built_in_function(Context& ctx, const EnvKey& key)
+  {
+    static const Built_In_Functions fns(make_built_in_functions(ctx));
+    Built_In_Functions::const_iterator it = fns.find(key);
+    return it != fns.end() ? it->second.ptr() : 0;
+  }
 
-  void register_built_in_functions(Context& ctx, Env* env)
+  void register_built_in_functions(Context& ctx, Built_In_Functions& fns)
   {
     using namespace Functions;
     // RGB Functions
-    register_function(ctx, rgb_sig, rgb, env);
-    register_overload_stub(ctx, "rgba", env);
-    register_function(ctx, rgba_4_sig, rgba_4, 4, env);
-    register_function(ctx, rgba_2_sig, rgba_2, 2, env);
-    register_function(ctx, red_sig, red, env);
-    register_function(ctx, green_sig, green, env);
-    register_function(ctx, blue_sig, blue, env);
-    register_function(ctx, mix_sig, mix, env);
+    register_function(ctx, rgb_sig, rgb, fns);
+    register_overload_stub(ctx, "rgba", fns);
+    register_function(ctx, rgba_4_sig, rgba_4, 4, fns);
+    register_function(ctx, rgba_2_sig, rgba_2, 2, fns);
+    register_function(ctx, red_sig, red, fns);
+    register_function(ctx, green_sig, green, fns);
+    register_function(ctx, blue_sig, blue, fns);
+    register_function(ctx, mix_sig, mix, fns);
     // HSL Functions
-    register_function(ctx, hsl_sig, hsl, env);
-    register_function(ctx, hsla_sig, hsla, env);
-    register_function(ctx, hue_sig, hue, env);
-    register_function(ctx, saturation_sig, saturation, env);
-    register_function(ctx, lightness_sig, lightness, env);
-    register_function(ctx, adjust_hue_sig, adjust_hue, env);
-    register_function(ctx, lighten_sig, lighten, env);
-    register_function(ctx, darken_sig, darken, env);
-    register_function(ctx, saturate_sig, saturate, env);
-    register_function(ctx, desaturate_sig, desaturate, env);
-    register_function(ctx, grayscale_sig, grayscale, env);
-    register_function(ctx, complement_sig, complement, env);
-    register_function(ctx, invert_sig, invert, env);
+    register_function(ctx, hsl_sig, hsl, fns);
+    register_function(ctx, hsla_sig, hsla, fns);
+    register_function(ctx, hue_sig, hue, fns);
+    register_function(ctx, saturation_sig, saturation, fns);
+    register_function(ctx, lightness_sig, lightness, fns);
+    register_function(ctx, adjust_hue_sig, adjust_hue, fns);
+    register_function(ctx, lighten_sig, lighten, fns);
+    register_function(ctx, darken_sig, darken, fns);
+    register_function(ctx, saturate_sig, saturate, fns);
+    register_function(ctx, desaturate_sig, desaturate, fns);
+    register_function(ctx, grayscale_sig, grayscale, fns);
+    register_function(ctx, complement_sig, complement, fns);
+    register_function(ctx, invert_sig, invert, fns);
     // Opacity Functions
-    register_function(ctx, alpha_sig, alpha, env);
-    register_function(ctx, opacity_sig, alpha, env);
-    register_function(ctx, opacify_sig, opacify, env);
-    register_function(ctx, fade_in_sig, opacify, env);
-    register_function(ctx, transparentize_sig, transparentize, env);
-    register_function(ctx, fade_out_sig, transparentize, env);
+    register_function(ctx, alpha_sig, alpha, fns);
+    register_function(ctx, opacity_sig, alpha, fns);
+    register_function(ctx, opacify_sig, opacify, fns);
+    register_function(ctx, fade_in_sig, opacify, fns);
+    register_function(ctx, transparentize_sig, transparentize, fns);
+    register_function(ctx, fade_out_sig, transparentize, fns);
     // Other Color Functions
-    register_function(ctx, adjust_color_sig, adjust_color, env);
-    register_function(ctx, scale_color_sig, scale_color, env);
-    register_function(ctx, change_color_sig, change_color, env);
-    register_function(ctx, ie_hex_str_sig, ie_hex_str, env);
+    register_function(ctx, adjust_color_sig, adjust_color, fns);
+    register_function(ctx, scale_color_sig, scale_color, fns);
+    register_function(ctx, change_color_sig, change_color, fns);
+    register_function(ctx, ie_hex_str_sig, ie_hex_str, fns);
     // String Functions
-    register_function(ctx, unquote_sig, sass_unquote, env);
-    register_function(ctx, quote_sig, sass_quote, env);
-    register_function(ctx, str_length_sig, str_length, env);
-    register_function(ctx, str_insert_sig, str_insert, env);
-    register_function(ctx, str_index_sig, str_index, env);
-    register_function(ctx, str_slice_sig, str_slice, env);
-    register_function(ctx, to_upper_case_sig, to_upper_case, env);
-    register_function(ctx, to_lower_case_sig, to_lower_case, env);
+    register_function(ctx, unquote_sig, sass_unquote, fns);
+    register_function(ctx, quote_sig, sass_quote, fns);
+    register_function(ctx, str_length_sig, str_length, fns);
+    register_function(ctx, str_insert_sig, str_insert, fns);
+    register_function(ctx, str_index_sig, str_index, fns);
+    register_function(ctx, str_slice_sig, str_slice, fns);
+    register_function(ctx, to_upper_case_sig, to_upper_case, fns);
+    register_function(ctx, to_lower_case_sig, to_lower_case, fns);
     // Number Functions
-    register_function(ctx, percentage_sig, percentage, env);
-    register_function(ctx, round_sig, round, env);
-    register_function(ctx, ceil_sig, ceil, env);
-    register_function(ctx, floor_sig, floor, env);
-    register_function(ctx, abs_sig, abs, env);
-    register_function(ctx, min_sig, min, env);
-    register_function(ctx, max_sig, max, env);
-    register_function(ctx, random_sig, random, env);
+    register_function(ctx, percentage_sig, percentage, fns);
+    register_function(ctx, round_sig, round, fns);
+    register_function(ctx, ceil_sig, ceil, fns);
+    register_function(ctx, floor_sig, floor, fns);
+    register_function(ctx, abs_sig, abs, fns);
+    register_function(ctx, min_sig, min, fns);
+    register_function(ctx, max_sig, max, fns);
+    register_function(ctx, random_sig, random, fns);
     // List Functions
-    register_function(ctx, length_sig, length, env);
-    register_function(ctx, nth_sig, nth, env);
-    register_function(ctx, set_nth_sig, set_nth, env);
-    register_function(ctx, index_sig, index, env);
-    register_function(ctx, join_sig, join, env);
-    register_function(ctx, append_sig, append, env);
-    register_function(ctx, zip_sig, zip, env);
-    register_function(ctx, list_separator_sig, list_separator, env);
-    register_function(ctx, is_bracketed_sig, is_bracketed, env);
+    register_function(ctx, length_sig, length, fns);
+    register_function(ctx, nth_sig, nth, fns);
+    register_function(ctx, set_nth_sig, set_nth, fns);
+    register_function(ctx, index_sig, index, fns);
+    register_function(ctx, join_sig, join, fns);
+    register_function(ctx, append_sig, append, fns);
+    register_function(ctx, zip_sig, zip, fns);
+    register_function(ctx, list_separator_sig, list_separator, fns);
+    register_function(ctx, is_bracketed_sig, is_bracketed, fns);
     // Map Functions
-    register_function(ctx, map_get_sig, map_get, env);
-    register_function(ctx, map_merge_sig, map_merge, env);
-    register_function(ctx, map_remove_sig, map_remove, env);
-    register_function(ctx, map_keys_sig, map_keys, env);
-    register_function(ctx, map_values_sig, map_values, env);
-    register_function(ctx, map_has_key_sig, map_has_key, env);
-    register_function(ctx, keywords_sig, keywords, env);
+    register_function(ctx, map_get_sig, map_get, fns);
+    register_function(ctx, map_merge_sig, map_merge, fns);
+    register_function(ctx, map_remove_sig, map_remove, fns);
+    register_function(ctx, map_keys_sig, map_keys, fns);
+    register_function(ctx, map_values_sig, map_values, fns);
+    register_function(ctx, map_has_key_sig, map_has_key, fns);
+    register_function(ctx, keywords_sig, keywords, fns);
     // Introspection Functions
-    register_function(ctx, type_of_sig, type_of, env);
-    register_function(ctx, unit_sig, unit, env);
-    register_function(ctx, unitless_sig, unitless, env);
-    register_function(ctx, comparable_sig, comparable, env);
-    register_function(ctx, variable_exists_sig, variable_exists, env);
-    register_function(ctx, global_variable_exists_sig, global_variable_exists, env);
-    register_function(ctx, function_exists_sig, function_exists, env);
-    register_function(ctx, mixin_exists_sig, mixin_exists, env);
-    register_function(ctx, feature_exists_sig, feature_exists, env);
-    register_function(ctx, call_sig, call, env);
-    register_function(ctx, content_exists_sig, content_exists, env);
-    register_function(ctx, get_function_sig, get_function, env);
+    register_function(ctx, type_of_sig, type_of, fns);
+    register_function(ctx, unit_sig, unit, fns);
+    register_function(ctx, unitless_sig, unitless, fns);
+    register_function(ctx, comparable_sig, comparable, fns);
+    register_function(ctx, variable_exists_sig, variable_exists, fns);
+    register_function(ctx, global_variable_exists_sig, global_variable_exists, fns);
+    register_function(ctx, function_exists_sig, function_exists, fns);
+    register_function(ctx, mixin_exists_sig, mixin_exists, fns);
+    register_function(ctx, feature_exists_sig, feature_exists, fns);
+    register_function(ctx, call_sig, call, fns);
+    register_function(ctx, content_exists_sig, content_exists, fns);
+    register_function(ctx, get_function_sig, get_function, fns);
     // Boolean Functions
-    register_function(ctx, not_sig, sass_not, env);
-    register_function(ctx, if_sig, sass_if, env);
+    register_function(ctx, not_sig, sass_not, fns);
+    register_function(ctx, if_sig, sass_if, fns);
     // Misc Functions
-    register_function(ctx, inspect_sig, inspect, env);
-    register_function(ctx, unique_id_sig, unique_id, env);
+    register_function(ctx, inspect_sig, inspect, fns);
+    register_function(ctx, unique_id_sig, unique_id, fns);
     // Selector functions
-    register_function(ctx, selector_nest_sig, selector_nest, env);
-    register_function(ctx, selector_append_sig, selector_append, env);
-    register_function(ctx, selector_extend_sig, selector_extend, env);
-    register_function(ctx, selector_replace_sig, selector_replace, env);
-    register_function(ctx, selector_unify_sig, selector_unify, env);
-    register_function(ctx, is_superselector_sig, is_superselector, env);
-    register_function(ctx, simple_selectors_sig, simple_selectors, env);
-    register_function(ctx, selector_parse_sig, selector_parse, env);
+    register_function(ctx, selector_nest_sig, selector_nest, fns);
+    register_function(ctx, selector_append_sig, selector_append, fns);
+    register_function(ctx, selector_extend_sig, selector_extend, fns);
+    register_function(ctx, selector_replace_sig, selector_replace, fns);
+    register_function(ctx, selector_unify_sig, selector_unify, fns);
+    register_function(ctx, is_superselector_sig, is_superselector, fns);
+    register_function(ctx, simple_selectors_sig, simple_selectors, fns);
+    register_function(ctx, selector_parse_sig, selector_parse, fns);
   }
 
   void register_c_functions(Context& ctx, Env* env, Sass_Function_List descrs)
@@ -19,6 +19,12 @@
 #include "output.hpp"
 #include "plugins.hpp"
 #include "file.hpp"
+#include "sheet_cache.hpp"
+#include "file_cache.hpp"
+#include "function_cache.hpp"
+#include "value_pool.hpp"
+#include "budget.hpp"
+#include "profiler.hpp"
 
 
 struct Sass_Function;
@@ -28,6 +34,7 @@ namespace Sass {
   class Context {
   public:
     void import_url (Import_Ptr imp, std::string load_path, const std::string& ctx_path);
+    static bool add_css_import(Import_Ptr imp, const std::string& load_path);
     bool call_headers(const std::string& load_path, const char* ctx_path, ParserState& pstate, Import_Ptr imp)
     { return call_loader(load_path, ctx_path, pstate, imp, c_headers, false); };
     bool call_importers(const std::string& load_path, const char* ctx_path, ParserState& pstate, Import_Ptr imp)
@@ -52,10 +59,30 @@ namespace Sass {
     std::vector<char*> strings;
     std::vector<Resource> resources;
     std::map<const std::string, StyleSheet> sheets;
+    // parsed sheets shared across compilations
+    Sheet_Cache* sheet_cache;
+    // leased sheets with their resource index
+    std::vector<std::pair<size_t, Cached_Sheet*>> cached_sheets;
+    // leased sheets parsed ahead by worker threads
+    std::map<std::string, Cached_Sheet*> prefetched_sheets;
+    // cached sheets currently being parsed
+    std::vector<Cached_Sheet*> sheet_stack;
+    // directory listings shared across compilations
+    File_Cache* file_cache;
+    // results of pure custom functions
+    Function_Cache* function_cache;
+    // recycled memory of values exchanged with custom functions
+    Value_Pool value_pool;
+    // timeout, step limit and cancellation
+    Budget budget;
+    // include paths and cwd the cached sheets depend on
+    std::string sheet_env;
     Subset_Map subset_map;
     std::vector<Sass_Import_Entry> import_stack;
     std::vector<Sass_Callee> callee_stack;
     std::vector<Backtrace> traces;
+    // phase times and callback counts
+    Profile profile;
 
     struct Sass_Compiler* c_compiler;
 
@@ -65,6 +92,9 @@ namespace Sass {
     std::vector<std::string> srcmap_links;
     // vectors above have same size
 
+    // resolved file imports (requested by, resolved to)
+    std::vector<std::pair<Importer, Include>> import_edges;
+
     std::vector<std::string> plugin_paths; // relative paths to load plugins
     std::vector<std::string> include_paths; // lookup paths for includes
 
@@ -101,10 +131,19 @@ namespace Sass {
     std::vector<Include> find_includes(const Importer& import);
     Include load_import(const Importer&, ParserState pstate);
 
+    // any loaded source contains non-ascii characters
+    bool has_utf8_sources();
+    bool use_sheet_cache();
+    Cached_Sheet* acquire_sheet(const std::string& abs_path);
+    bool load_sheet(const Include&, ParserState& pstate);
+    void register_sheet(const Include&, Cached_Sheet* sheet);
+    void register_sheet(const Include&, Cached_Sheet* sheet, ParserState&);
+
     Sass_Output_Style output_style() { return c_options.output_style; };
     std::vector<std::string> get_included_files(bool skip = false, size_t headers = 0);
 
   private:
+    void check_import_loop(Sass_Import_Entry import, ParserState& pstate);
     void collect_plugin_paths(const char* paths_str);
     void collect_plugin_paths(string_list* paths_array);
     void collect_include_paths(const char* paths_str);
@@ -6,17 +6,17 @@ namespace Sass {
 
   template <typename T>
   Environment<T>::Environment(bool is_shadow)
-  : local_frame_(environment_map<std::string, T>()),
+  : local_frame_(environment_map<EnvKey, T, HashEnvKey>()),
     parent_(0), is_shadow_(false)
   { }
   template <typename T>
   Environment<T>::Environment(Environment<T>* env, bool is_shadow)
-  : local_frame_(environment_map<std::string, T>()),
+  : local_frame_(environment_map<EnvKey, T, HashEnvKey>()),
     parent_(env), is_shadow_(is_shadow)
   { }
   template <typename T>
   Environment<T>::Environment(Environment<T>& env, bool is_shadow)
-  : local_frame_(environment_map<std::string, T>()),
+  : local_frame_(environment_map<EnvKey, T, HashEnvKey>()),
     parent_(&env), is_shadow_(is_shadow)
   { }
 
@@ -45,16 +45,16 @@ namespace Sass {
   }
 
   template <typename T>
-  environment_map<std::string, T>& Environment<T>::local_frame() {
+  environment_map<EnvKey, T, HashEnvKey>& Environment<T>::local_frame() {
     return local_frame_;
   }
 
   template <typename T>
-  bool Environment<T>::has_local(const std::string& key) const
+  bool Environment<T>::has_local(const EnvKey& key) const
   { return local_frame_.find(key) != local_frame_.end(); }
 
   template <typename T> EnvResult
-  Environment<T>::find_local(const std::string& key)
+  Environment<T>::find_local(const EnvKey& key)
   {
     auto end = local_frame_.end();
     auto it = local_frame_.find(key);
@@ -62,22 +62,22 @@ namespace Sass {
   }
 
   template <typename T>
-  T& Environment<T>::get_local(const std::string& key)
+  T& Environment<T>::get_local(const EnvKey& key)
   { return local_frame_[key]; }
 
   template <typename T>
-  void Environment<T>::set_local(const std::string& key, const T& val)
+  void Environment<T>::set_local(const EnvKey& key, const T& val)
   {
     local_frame_[key] = val;
   }
   template <typename T>
-  void Environment<T>::set_local(const std::string& key, T&& val)
+  void Environment<T>::set_local(const EnvKey& key, T&& val)
   {
     local_frame_[key] = val;
   }
 
   template <typename T>
-  void Environment<T>::del_local(const std::string& key)
+  void Environment<T>::del_local(const EnvKey& key)
   { local_frame_.erase(key); }
 
   template <typename T>
@@ -91,30 +91,30 @@ namespace Sass {
   }
 
   template <typename T>
-  bool Environment<T>::has_global(const std::string& key)
+  bool Environment<T>::has_global(const EnvKey& key)
   { return global_env()->has(key); }
 
   template <typename T>
-  T& Environment<T>::get_global(const std::string& key)
+  T& Environment<T>::get_global(const EnvKey& key)
   { return (*global_env())[key]; }
 
   template <typename T>
-  void Environment<T>::set_global(const std::string& key, const T& val)
+  void Environment<T>::set_global(const EnvKey& key, const T& val)
   {
     global_env()->local_frame_[key] = val;
   }
   template <typename T>
-  void Environment<T>::set_global(const std::string& key, T&& val)
+  void Environment<T>::set_global(const EnvKey& key, T&& val)
   {
     global_env()->local_frame_[key] = val;
   }
 
   template <typename T>
-  void Environment<T>::del_global(const std::string& key)
+  void Environment<T>::del_global(const EnvKey& key)
   { global_env()->local_frame_.erase(key); }
 
   template <typename T>
-  Environment<T>* Environment<T>::lexical_env(const std::string& key)
+  Environment<T>* Environment<T>::lexical_env(const EnvKey& key)
   {
     Environment* cur = this;
     while (cur) {
@@ -130,7 +130,7 @@ namespace Sass {
   // move down the stack but stop before we
   // reach the global frame (is not included)
   template <typename T>
-  bool Environment<T>::has_lexical(const std::string& key) const
+  bool Environment<T>::has_lexical(const EnvKey& key) const
   {
     auto cur = this;
     while (cur->is_lexical()) {
@@ -144,7 +144,7 @@ namespace Sass {
   // either update already existing lexical value
   // or if flag is set, we create one if no lexical found
   template <typename T>
-  void Environment<T>::set_lexical(const std::string& key, const T& val)
+  void Environment<T>::set_lexical(const EnvKey& key, const T& val)
   {
     Environment<T>* cur = this;
     bool shadow = false;
@@ -161,7 +161,7 @@ namespace Sass {
   }
   // this one moves the value
   template <typename T>
-  void Environment<T>::set_lexical(const std::string& key, T&& val)
+  void Environment<T>::set_lexical(const EnvKey& key, T&& val)
   {
     Environment<T>* cur = this;
     bool shadow = false;
@@ -180,7 +180,7 @@ namespace Sass {
   // look on the full stack for key
   // include all scopes available
   template <typename T>
-  bool Environment<T>::has(const std::string& key) const
+  bool Environment<T>::has(const EnvKey& key) const
   {
     auto cur = this;
     while (cur) {
@@ -195,7 +195,7 @@ namespace Sass {
   // look on the full stack for key
   // include all scopes available
   template <typename T> EnvResult
-  Environment<T>::find(const std::string& key)
+  Environment<T>::find(const EnvKey& key)
   {
     auto cur = this;
     while (true) {
@@ -208,7 +208,7 @@ namespace Sass {
 
   // use array access for getter and setter functions
   template <typename T>
-  T& Environment<T>::operator[](const std::string& key)
+  T& Environment<T>::operator[](const EnvKey& key)
   {
     auto cur = this;
     while (cur) {
@@ -227,9 +227,9 @@ namespace Sass {
     size_t indent = 0;
     if (parent_) indent = parent_->print(prefix) + 1;
     std::cerr << prefix << std::string(indent, ' ') << "== " << this << std::endl;
-    for (typename environment_map<std::string, T>::iterator i = local_frame_.begin(); i != local_frame_.end(); ++i) {
-      if (!ends_with(i->first, "[f]") && !ends_with(i->first, "[f]4") && !ends_with(i->first, "[f]2")) {
-        std::cerr << prefix << std::string(indent, ' ') << i->first << " " << i->second;
+    for (typename environment_map<EnvKey, T, HashEnvKey>::iterator i = local_frame_.begin(); i != local_frame_.end(); ++i) {
+      if (!ends_with(i->first.name(), "[f]") && !ends_with(i->first.name(), "[f]4") && !ends_with(i->first.name(), "[f]2")) {
+        std::cerr << prefix << std::string(indent, ' ') << i->first.name() << " " << i->second;
         if (Value_Ptr val = Cast<Value>(i->second))
         { std::cerr << " : " << val->to_string(); }
         std::cerr << std::endl;
@@ -2,12 +2,39 @@
 #define SASS_ENVIRONMENT_H
 
 #include <string>
+#include <utility>
+#include <functional>
 #include "ast_fwd_decl.hpp"
 #include "ast_def_macros.hpp"
 
 namespace Sass {
 
-  typedef environment_map<std::string, AST_Node_Obj>::iterator EnvIter;
+  // Name of a variable, function or mixin with a precomputed
+  // hash. The hash is calculated once per lookup (or once when
+  // the node is parsed) and not again for every frame on the stack.
+  class EnvKey {
+    private:
+      std::string name_;
+      size_t hash_;
+    public:
+      EnvKey(const std::string& name)
+      : name_(name), hash_(std::hash<std::string>()(name_)) {}
+      EnvKey(std::string&& name)
+      : name_(std::move(name)), hash_(std::hash<std::string>()(name_)) {}
+      EnvKey(const char* name)
+      : name_(name), hash_(std::hash<std::string>()(name_)) {}
+      const std::string& name() const { return name_; }
+      size_t hash() const { return hash_; }
+      bool operator==(const EnvKey& rhs) const
+      { return hash_ == rhs.hash_ && name_ == rhs.name_; }
+  };
+
+  struct HashEnvKey {
+    size_t operator()(const EnvKey& key) const
+    { return key.hash(); }
+  };
+
+  typedef environment_map<EnvKey, AST_Node_Obj, HashEnvKey>::iterator EnvIter;
 
   class EnvResult {
     public:
@@ -21,7 +48,7 @@ namespace Sass {
   template <typename T>
   class Environment {
     // TODO: test with map
-    environment_map<std::string, T> local_frame_;
+    environment_map<EnvKey, T, HashEnvKey> local_frame_;
     ADD_PROPERTY(Environment*, parent)
     ADD_PROPERTY(bool, is_shadow)
 
@@ -46,58 +73,58 @@ namespace Sass {
 
     // scope operates on the current frame
 
-    environment_map<std::string, T>& local_frame();
+    environment_map<EnvKey, T, HashEnvKey>& local_frame();
 
-    bool has_local(const std::string& key) const;
+    bool has_local(const EnvKey& key) const;
 
-    EnvResult find_local(const std::string& key);
+    EnvResult find_local(const EnvKey& key);
 
-    T& get_local(const std::string& key);
+    T& get_local(const EnvKey& key);
 
     // set variable on the current frame
-    void set_local(const std::string& key, const T& val);
-    void set_local(const std::string& key, T&& val);
+    void set_local(const EnvKey& key, const T& val);
+    void set_local(const EnvKey& key, T&& val);
 
-    void del_local(const std::string& key);
+    void del_local(const EnvKey& key);
 
     // global operates on the global frame
     // which is the second last on the stack
     Environment* global_env();
     // get the env where the variable already exists
     // if it does not yet exist, we return current env
-    Environment* lexical_env(const std::string& key);
+    Environment* lexical_env(const EnvKey& key);
 
-    bool has_global(const std::string& key);
+    bool has_global(const EnvKey& key);
 
-    T& get_global(const std::string& key);
+    T& get_global(const EnvKey& key);
 
     // set a variable on the global frame
-    void set_global(const std::string& key, const T& val);
-    void set_global(const std::string& key, T&& val);
+    void set_global(const EnvKey& key, const T& val);
+    void set_global(const EnvKey& key, T&& val);
 
-    void del_global(const std::string& key);
+    void del_global(const EnvKey& key);
 
     // see if we have a lexical variable
     // move down the stack but stop before we
     // reach the global frame (is not included)
-    bool has_lexical(const std::string& key) const;
+    bool has_lexical(const EnvKey& key) const;
 
     // see if we have a lexical we could update
     // either update already existing lexical value
     // or we create a new one on the current frame
-    void set_lexical(const std::string& key, T&& val);
-    void set_lexical(const std::string& key, const T& val);
+    void set_lexical(const EnvKey& key, T&& val);
+    void set_lexical(const EnvKey& key, const T& val);
 
     // look on the full stack for key
     // include all scopes available
-    bool has(const std::string& key) const;
+    bool has(const EnvKey& key) const;
 
     // look on the full stack for key
     // include all scopes available
-    EnvResult find(const std::string& key);
+    EnvResult find(const EnvKey& key);
 
     // use array access for getter and setter functions
-    T& operator[](const std::string& key);
+    T& operator[](const EnvKey& key);
 
     #ifdef DEBUG
     size_t print(std::string prefix = "");
@@ -62,6 +62,10 @@ namespace Sass {
     : Base(pstate, msg, traces)
     { }
 
+    Cancelled::Cancelled(ParserState pstate, Backtraces traces, std::string msg)
+    : Base(pstate, msg, traces)
+    { }
+
     DuplicateKeyError::DuplicateKeyError(Backtraces traces, const Map& dup, const Expression& org)
     : Base(org.pstate(), def_msg, traces), dup(dup), org(org)
     {
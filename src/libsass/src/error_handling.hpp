@@ -91,6 +91,12 @@ namespace Sass {
         virtual ~NestingLimitError() throw() {};
     };
 
+    class Cancelled : public Base {
+      public:
+        Cancelled(ParserState pstate, Backtraces traces, std::string msg);
+        virtual ~Cancelled() throw() {};
+    };
+
     class DuplicateKeyError : public Base {
       protected:
         const Map& dup;
@@ -26,9 +26,17 @@
 #include "expand.hpp"
 #include "color_maps.hpp"
 #include "sass_functions.hpp"
+#include "profiler.hpp"
 
 namespace Sass {
 
+  // run a custom function and account for it in the profile
+  static union Sass_Value* call_c_function(Context& ctx, Sass_Function_Entry c_function, union Sass_Value* c_args)
+  {
+    Callback_Timer timer(ctx.profile.functions);
+    return sass_function_get_function(c_function)(c_args, c_function, ctx.c_compiler);
+  }
+
   Eval::Eval(Expand& exp)
   : exp(exp),
     ctx(exp.ctx),
@@ -65,7 +73,8 @@ namespace Sass {
   Expression_Ptr Eval::operator()(Assignment_Ptr a)
   {
     Env* env = exp.environment();
-    std::string var(a->variable());
+    // hash the name once for all lookups
+    const EnvKey var(a->variable());
     if (a->is_global()) {
       if (a->is_default()) {
         if (env->has_global(var)) {
@@ -176,6 +185,7 @@ namespace Sass {
       for (double i = start;
            i < end;
            ++i) {
+        ctx.budget.step(f->pstate(), traces);
         Number_Obj it = SASS_MEMORY_NEW(Number, low->pstate(), i, sass_end->unit());
         env.set_local(variable, it);
         val = body->perform(this);
@@ -186,6 +196,7 @@ namespace Sass {
       for (double i = start;
            i > end;
            --i) {
+        ctx.budget.step(f->pstate(), traces);
         Number_Obj it = SASS_MEMORY_NEW(Number, low->pstate(), i, sass_end->unit());
         env.set_local(variable, it);
         val = body->perform(this);
@@ -227,6 +238,7 @@ namespace Sass {
 
     if (map) {
       for (Expression_Obj key : map->keys()) {
+        ctx.budget.step(e->pstate(), traces);
         Expression_Obj value = map->at(key);
 
         if (variables.size() == 1) {
@@ -248,6 +260,7 @@ namespace Sass {
         list = Cast<List>(list);
       }
       for (size_t i = 0, L = list->length(); i < L; ++i) {
+        ctx.budget.step(e->pstate(), traces);
         Expression_Ptr item = list->at(i);
         // unwrap value if the expression is an argument
         if (Argument_Ptr arg = Cast<Argument>(item)) item = arg->value();
@@ -291,6 +304,7 @@ namespace Sass {
     exp.env_stack.push_back(&env);
     Expression_Obj cond = pred->perform(this);
     while (!cond->is_false()) {
+      ctx.budget.step(w->pstate(), traces);
       Expression_Obj val = body->perform(this);
       if (val) {
         exp.env_stack.pop_back();
@@ -331,12 +345,11 @@ namespace Sass {
       // Block_Obj          body   = def->block();
       // Native_Function func   = def->native_function();
       Sass_Function_Entry c_function = def->c_function();
-      Sass_Function_Fn c_func = sass_function_get_function(c_function);
 
-      To_C to_c;
+      To_C to_c(true);
       union Sass_Value* c_args = sass_make_list(1, SASS_COMMA, false);
       sass_list_set_value(c_args, 0, message->perform(&to_c));
-      union Sass_Value* c_val = c_func(c_args, c_function, ctx.c_compiler);
+      union Sass_Value* c_val = call_c_function(ctx, c_function, c_args);
       ctx.c_options.output_style = outstyle;
       ctx.callee_stack.pop_back();
       sass_delete_value(c_args);
@@ -379,12 +392,11 @@ namespace Sass {
       // Block_Obj          body   = def->block();
       // Native_Function func   = def->native_function();
       Sass_Function_Entry c_function = def->c_function();
-      Sass_Function_Fn c_func = sass_function_get_function(c_function);
 
-      To_C to_c;
+      To_C to_c(true);
       union Sass_Value* c_args = sass_make_list(1, SASS_COMMA, false);
       sass_list_set_value(c_args, 0, message->perform(&to_c));
-      union Sass_Value* c_val = c_func(c_args, c_function, ctx.c_compiler);
+      union Sass_Value* c_val = call_c_function(ctx, c_function, c_args);
       ctx.c_options.output_style = outstyle;
       ctx.callee_stack.pop_back();
       sass_delete_value(c_args);
@@ -423,12 +435,11 @@ namespace Sass {
       // Block_Obj          body   = def->block();
       // Native_Function func   = def->native_function();
       Sass_Function_Entry c_function = def->c_function();
-      Sass_Function_Fn c_func = sass_function_get_function(c_function);
 
-      To_C to_c;
+      To_C to_c(true);
       union Sass_Value* c_args = sass_make_list(1, SASS_COMMA, false);
       sass_list_set_value(c_args, 0, message->perform(&to_c));
-      union Sass_Value* c_val = c_func(c_args, c_function, ctx.c_compiler);
+      union Sass_Value* c_val = call_c_function(ctx, c_function, c_args);
       ctx.c_options.output_style = outstyle;
       ctx.callee_stack.pop_back();
       sass_delete_value(c_args);
@@ -914,6 +925,15 @@ namespace Sass {
     return u;
   }
 
+  // functions defined in scss or via the C-API
+  // shadow the shared built-in functions
+  static Definition_Ptr find_function(Context& ctx, Env* env, const EnvKey& key)
+  {
+    EnvResult rv(env->find(key));
+    if (rv.found) return Cast<Definition>(rv.it->second);
+    return built_in_function(ctx, key);
+  }
+
   Expression_Ptr Eval::operator()(Function_Call_Ptr c)
   {
     if (traces.size() > Constants::MaxCallStack) {
@@ -922,13 +942,15 @@ namespace Sass {
         stm << "Stack depth exceeded max of " << Constants::MaxCallStack;
         error(stm.str(), c->pstate(), traces);
     }
-    std::string name(Util::normalize_underscores(c->name()));
-    std::string full_name(name + "[f]");
+    // normalized name plus suffix, built with the node
+    // (the suffix does not change the special match)
+    std::string full_name(c->key().name());
     // we make a clone here, need to implement that further
     Arguments_Obj args = c->arguments();
 
     Env* env = environment();
-    if (!env->has(full_name) || (!c->via_call() && Prelexer::re_special_fun(name.c_str()))) {
+    Definition_Ptr def = find_function(ctx, env, c->key());
+    if (!def || (!c->via_call() && Prelexer::re_special_fun(full_name.c_str()))) {
       if (!env->has("*[f]")) {
         for (Argument_Obj arg : args->elements()) {
           if (List_Obj ls = Cast<List>(arg->value())) {
@@ -951,6 +973,7 @@ namespace Sass {
       } else {
         // call generic function
         full_name = "*[f]";
+        def = Cast<Definition>((*env)[full_name]);
       }
     }
 
@@ -961,8 +984,6 @@ namespace Sass {
     if (full_name != "if[f]") {
       args = Cast<Arguments>(args->perform(this));
     }
-    Definition_Ptr def = Cast<Definition>((*env)[full_name]);
-
     if (c->func()) def = c->func()->definition();
 
     if (def->is_overload_stub()) {
@@ -978,8 +999,8 @@ namespace Sass {
       ss << full_name << L;
       full_name = ss.str();
       std::string resolved_name(full_name);
-      if (!env->has(resolved_name)) error("overloaded function `" + std::string(c->name()) + "` given wrong number of arguments", c->pstate(), traces);
-      def = Cast<Definition>((*env)[resolved_name]);
+      def = find_function(ctx, env, resolved_name);
+      if (!def) error("overloaded function `" + std::string(c->name()) + "` given wrong number of arguments", c->pstate(), traces);
     }
 
     Expression_Obj     result = c;
@@ -990,7 +1011,8 @@ namespace Sass {
     if (c->is_css()) return result.detach();
 
     Parameters_Obj params = def->parameters();
-    Env fn_env(def->environment());
+    // built-in functions have no environment of their own
+    Env fn_env(def->environment() ? def->environment() : env->global_env());
     exp.env_stack.push_back(&fn_env);
 
     if (func || body) {
@@ -1023,7 +1045,6 @@ namespace Sass {
     // else if it's a user-defined c function
     // convert call into C-API compatible form
     else if (c_function) {
-      Sass_Function_Fn c_func = sass_function_get_function(c_function);
       if (full_name == "*[f]") {
         String_Quoted_Obj str = SASS_MEMORY_NEW(String_Quoted, c->pstate(), c->name());
         Arguments_Obj new_args = SASS_MEMORY_NEW(Arguments, c->pstate());
@@ -1046,16 +1067,33 @@ namespace Sass {
         { env }
       });
 
-      To_C to_c;
-      union Sass_Value* c_args = sass_make_list(params->length(), SASS_COMMA, false);
+      std::vector<Expression_Obj> values;
       for(size_t i = 0; i < params->length(); i++) {
         Parameter_Obj param = params->at(i);
         std::string key = param->name();
         AST_Node_Obj node = fn_env.get_local(key);
-        Expression_Obj arg = Cast<Expression>(node);
-        sass_list_set_value(c_args, i, arg->perform(&to_c));
+        values.push_back(Cast<Expression>(node));
+      }
+
+      // pure functions are only called once per distinct arguments
+      Function_Cache* cache = sass_function_get_pure(c_function) ? ctx.function_cache : 0;
+      Function_Cache::Key cache_key;
+      union Sass_Value* c_args = 0;
+      union Sass_Value* c_val = 0;
+      if (cache) {
+        cache_key = Function_Cache::make_key(sass_function_get_signature(c_function), values);
+        c_val = cache->get(cache_key);
+      }
+      if (!c_val) {
+        // the arguments are deleted while the values are alive
+        To_C to_c(true);
+        c_args = sass_make_list(values.size(), SASS_COMMA, false);
+        for(size_t i = 0; i < values.size(); i++) {
+          sass_list_set_value(c_args, i, values[i]->perform(&to_c));
+        }
+        c_val = call_c_function(ctx, c_function, c_args);
+        if (cache) cache->put(cache_key, c_val);
       }
-      union Sass_Value* c_val = c_func(c_args, c_function, ctx.c_compiler);
       if (sass_value_get_tag(c_val) == SASS_ERROR) {
         error("error in C function " + c->name() + ": " + sass_error_get_message(c_val), c->pstate(), traces);
       } else if (sass_value_get_tag(c_val) == SASS_WARNING) {
@@ -1065,7 +1103,7 @@ namespace Sass {
 
       ctx.callee_stack.pop_back();
       traces.pop_back();
-      sass_delete_value(c_args);
+      if (c_args) sass_delete_value(c_args);
       if (c_val != c_args)
         sass_delete_value(c_val);
     }
@@ -1095,8 +1133,7 @@ namespace Sass {
   {
     Expression_Obj value = 0;
     Env* env = environment();
-    const std::string& name(v->name());
-    EnvResult rv(env->find(name));
+    EnvResult rv(env->find(v->key()));
     if (rv.found) value = static_cast<Expression*>(rv.it->second.ptr());
     else error("Undefined variable: \"" + v->name() + "\".", v->pstate(), traces);
     if (Argument_Ptr arg = Cast<Argument>(value)) value = arg->value();
@@ -266,7 +266,8 @@ namespace Sass {
   Statement_Ptr Expand::operator()(Assignment_Ptr a)
   {
     Env* env = environment();
-    const std::string& var(a->variable());
+    // hash the name once for all lookups
+    const EnvKey var(a->variable());
     if (a->is_global()) {
       if (a->is_default()) {
         if (env->has_global(var)) {
@@ -458,6 +459,7 @@ namespace Sass {
       for (double i = start;
            i < end;
            ++i) {
+        ctx.budget.step(f->pstate(), traces);
         Number_Obj it = SASS_MEMORY_NEW(Number, low->pstate(), i, sass_end->unit());
         env.set_local(variable, it);
         append_block(body);
@@ -467,6 +469,7 @@ namespace Sass {
       for (double i = start;
            i > end;
            --i) {
+        ctx.budget.step(f->pstate(), traces);
         Number_Obj it = SASS_MEMORY_NEW(Number, low->pstate(), i, sass_end->unit());
         env.set_local(variable, it);
         append_block(body);
@@ -508,6 +511,7 @@ namespace Sass {
 
     if (map) {
       for (auto key : map->keys()) {
+        ctx.budget.step(e->pstate(), traces);
         Expression_Obj k = key->perform(&eval);
         Expression_Obj v = map->at(key)->perform(&eval);
 
@@ -529,6 +533,7 @@ namespace Sass {
         list = Cast<List>(list);
       }
       for (size_t i = 0, L = list->length(); i < L; ++i) {
+        ctx.budget.step(e->pstate(), traces);
         Expression_Obj item = list->at(i);
         // unwrap value if the expression is an argument
         if (Argument_Obj arg = Cast<Argument>(item)) item = arg->value();
@@ -572,6 +577,7 @@ namespace Sass {
     call_stack.push_back(w);
     Expression_Obj cond = pred->perform(&eval);
     while (!cond->is_false()) {
+      ctx.budget.step(w->pstate(), traces);
       append_block(body);
       cond = pred->perform(&eval);
     }
@@ -703,11 +709,11 @@ namespace Sass {
     recursions ++;
 
     Env* env = environment();
-    std::string full_name(c->name() + "[m]");
-    if (!env->has(full_name)) {
+    EnvResult mixin(env->find(c->name() + "[m]"));
+    if (!mixin.found) {
       error("no mixin named " + c->name(), c->pstate(), traces);
     }
-    Definition_Obj def = Cast<Definition>((*env)[full_name]);
+    Definition_Obj def = Cast<Definition>(mixin.it->second);
     Block_Obj body = def->block();
     Parameters_Obj params = def->parameters();
 
@@ -1532,6 +1532,9 @@ namespace Sass {
     DEBUG_EXEC(EXTEND_COMPOUND, printCompoundSelector(pSelector, "EXTEND COMPOUND: "))
     // TODO: Ruby has another loop here to skip certain members?
 
+    // selector functions extend without a compile
+    if (eval) eval->ctx.budget.step(pSelector->pstate(), eval->traces);
+
     // let RESULTS be an empty list of complex selectors
     Node results = Node::createCollection();
     // extendedSelectors.got_line_feed = true;
@@ -1750,6 +1753,8 @@ namespace Sass {
       return memoized->second;
     }
 
+    if (eval) eval->ctx.budget.step(selector->pstate(), eval->traces);
+
     // convert the input selector to extend node format
     Node complexSelector = complexSelectorToNode(selector);
     DEBUG_PRINTLN(EXTEND_COMPLEX, "EXTEND COMPLEX: " << complexSelector)
@@ -9,14 +9,19 @@
 # define S_ISDIR(mode) (((mode) & S_IFMT) == S_IFDIR)
 #else
 # include <unistd.h>
+# include <fcntl.h>
+# include <sys/mman.h>
 #endif
 #include <iostream>
 #include <fstream>
 #include <cctype>
 #include <vector>
+#include <mutex>
 #include <algorithm>
+#include <unordered_map>
 #include <sys/stat.h>
 #include "file.hpp"
+#include "file_cache.hpp"
 #include "context.hpp"
 #include "prelexer.hpp"
 #include "utf8_string.hpp"
@@ -94,6 +99,35 @@ namespace Sass {
       #endif
     }
 
+    // query modification time and size of a file
+    // returns false if path does not exist or is a directory
+    bool file_stats(const std::string& path, long long& mtime, size_t& size)
+    {
+      #ifdef _WIN32
+        wchar_t resolved[32768];
+        // windows unicode filepaths are encoded in utf16
+        std::string abspath(join_paths(get_cwd(), path));
+        std::wstring wpath(UTF_8::convert_to_utf16("\\\\?\\" + abspath));
+        std::replace(wpath.begin(), wpath.end(), '/', '\\');
+        DWORD rv = GetFullPathNameW(wpath.c_str(), 32767, resolved, NULL);
+        if (rv > 32767) throw Exception::OperationError("Path is too long");
+        if (rv == 0) throw Exception::OperationError("Path could not be resolved");
+        WIN32_FILE_ATTRIBUTE_DATA data;
+        if (!GetFileAttributesExW(resolved, GetFileExInfoStandard, &data)) return false;
+        if (data.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) return false;
+        mtime = ((long long) data.ftLastWriteTime.dwHighDateTime << 32) | data.ftLastWriteTime.dwLowDateTime;
+        size = (size_t) (((unsigned long long) data.nFileSizeHigh << 32) | data.nFileSizeLow);
+        return true;
+      #else
+        struct stat st_buf;
+        if (stat(path.c_str(), &st_buf) != 0) return false;
+        if (S_ISDIR(st_buf.st_mode)) return false;
+        mtime = (long long) st_buf.st_mtime;
+        size = (size_t) st_buf.st_size;
+        return true;
+      #endif
+    }
+
     // return if given path is absolute
     // works with *nix and windows paths
     bool is_absolute_path(const std::string& path)
@@ -323,9 +357,15 @@ namespace Sass {
     // (2) underscore + given
     // (3) underscore + given + extension
     // (4) given + extension
-    std::vector<Include> resolve_includes(const std::string& root, const std::string& file, const std::vector<std::string>& exts)
+    std::vector<Include> resolve_includes(const std::string& root, const std::string& file, const std::vector<std::string>& exts, File_Cache* cache)
     {
       std::string filename = join_paths(root, file);
+      // listings are cached by absolute paths
+      std::string cache_root(cache ? rel2abs(root) : root);
+      auto exists = [&](const std::string& rel_path, const std::string& abs_path) {
+        if (cache == 0) return File::file_exists(abs_path);
+        return cache->file_exists(join_paths(cache_root, rel_path));
+      };
       // split the filename
       std::string base(dir_name(file));
       std::string name(base_name(file));
@@ -333,22 +373,22 @@ namespace Sass {
       // create full path (maybe relative)
       std::string rel_path(join_paths(base, name));
       std::string abs_path(join_paths(root, rel_path));
-      if (file_exists(abs_path)) includes.push_back({{ rel_path, root }, abs_path });
+      if (exists(rel_path, abs_path)) includes.push_back({{ rel_path, root }, abs_path });
       // next test variation with underscore
       rel_path = join_paths(base, "_" + name);
       abs_path = join_paths(root, rel_path);
-      if (file_exists(abs_path)) includes.push_back({{ rel_path, root }, abs_path });
+      if (exists(rel_path, abs_path)) includes.push_back({{ rel_path, root }, abs_path });
       // next test exts plus underscore
       for(auto ext : exts) {
         rel_path = join_paths(base, "_" + name + ext);
         abs_path = join_paths(root, rel_path);
-        if (file_exists(abs_path)) includes.push_back({{ rel_path, root }, abs_path });
+        if (exists(rel_path, abs_path)) includes.push_back({{ rel_path, root }, abs_path });
       }
       // next test plain name with exts
       for(auto ext : exts) {
         rel_path = join_paths(base, name + ext);
         abs_path = join_paths(root, rel_path);
-        if (file_exists(abs_path)) includes.push_back({{ rel_path, root }, abs_path });
+        if (exists(rel_path, abs_path)) includes.push_back({{ rel_path, root }, abs_path });
       }
       // nothing found
       return includes;
@@ -400,10 +440,56 @@ namespace Sass {
       return std::string("");
     }
 
+    #ifndef _WIN32
+    // smaller files are cheaper to copy
+    const size_t map_threshold = 64 * 1024;
+
+    // mapped buffers and their length
+    static std::mutex mapped_mutex;
+    static std::unordered_map<char*, size_t> mapped_files;
+
+    // map the file read only, the lexer needs two
+    // null chars after the content, which the kernel
+    // provides by zero filling the rest of the last
+    // page (returns null if the file must be copied)
+    static char* map_file(const std::string& path, size_t size)
+    {
+      static const size_t page_size = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+      if (size < map_threshold) return 0;
+      size_t tail = size % page_size;
+      if (tail == 0 || tail > page_size - 2) return 0;
+      int fd = open(path.c_str(), O_RDONLY);
+      if (fd == -1) return 0;
+      void* addr = mmap(0, size, PROT_READ, MAP_PRIVATE, fd, 0);
+      close(fd);
+      if (addr == MAP_FAILED) return 0;
+      std::lock_guard<std::mutex> lock(mapped_mutex);
+      mapped_files[static_cast<char*>(addr)] = size;
+      return static_cast<char*>(addr);
+    }
+    #endif
+
+    void free_file(char* contents)
+    {
+      #ifndef _WIN32
+        if (contents == 0) return;
+        std::unique_lock<std::mutex> lock(mapped_mutex);
+        auto it = mapped_files.find(contents);
+        if (it != mapped_files.end()) {
+          size_t size = it->second;
+          mapped_files.erase(it);
+          lock.unlock();
+          munmap(contents, size);
+          return;
+        }
+      #endif
+      free(contents);
+    }
+
     // try to load the given filename
     // returned memory must be freed
     // will auto convert .sass files
-    char* read_file(const std::string& path)
+    char* read_file(const std::string& path, bool mapped)
     {
       #ifdef _WIN32
         BYTE* pBuffer;
@@ -432,8 +518,10 @@ namespace Sass {
       #else
         struct stat st;
         if (stat(path.c_str(), &st) == -1 || S_ISDIR(st.st_mode)) return 0;
-        std::ifstream file(path.c_str(), std::ios::in | std::ios::binary | std::ios::ate);
-        char* contents = 0;
+        // parser states point directly into the mapping
+        char* contents = mapped ? map_file(path, st.st_size) : 0;
+        std::ifstream file;
+        if (contents == 0) file.open(path.c_str(), std::ios::in | std::ios::binary | std::ios::ate);
         if (file.is_open()) {
           size_t size = file.tellg();
           // allocate an extra byte for the null char
@@ -454,7 +542,7 @@ namespace Sass {
         extension[i] = tolower(extension[i]);
       if (extension == ".sass" && contents != 0) {
         char * converted = sass2scss(contents, SASS2SCSS_PRETTIFY_1 | SASS2SCSS_KEEP_COMMENT);
-        free(contents); // free the indented contents
+        free_file(contents); // free the indented contents
         return converted; // should be freed by caller
       } else {
         return contents;
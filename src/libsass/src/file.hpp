@@ -9,6 +9,8 @@
 
 namespace Sass {
 
+  class File_Cache;
+
   namespace File {
 
     // return the current directory
@@ -18,6 +20,10 @@ namespace Sass {
     // test if path exists and is a file
     bool file_exists(const std::string& file);
 
+    // query modification time and size of a file
+    // returns false if path does not exist or is a directory
+    bool file_stats(const std::string& file, long long& mtime, size_t& size);
+
     // return if given path is absolute
     // works with *nix and windows paths
     bool is_absolute_path(const std::string& path);
@@ -61,8 +67,14 @@ namespace Sass {
 
     // try to load the given filename
     // returned memory must be freed
+    // with free_file (not free)
     // will auto convert .sass files
-    char* read_file(const std::string& file);
+    // big files may be memory mapped
+    char* read_file(const std::string& file, bool mapped = false);
+
+    // release a buffer returned by read_file
+    // or any other malloc'd source buffer
+    void free_file(char* contents);
 
   }
 
@@ -123,8 +135,9 @@ namespace Sass {
 
     static std::vector<std::string> defaultExtensions = { ".scss", ".sass", ".css" };
 
+    // answers the probes from the cache if given
     std::vector<Include> resolve_includes(const std::string& root, const std::string& file,
-      const std::vector<std::string>& exts = defaultExtensions);
+      const std::vector<std::string>& exts = defaultExtensions, File_Cache* cache = 0);
 
   }
 
@@ -0,0 +1,140 @@
+#include "sass.hpp"
+#ifndef _WIN32
+# include <dirent.h>
+# include <sys/stat.h>
+#endif
+#include <cctype>
+#include <vector>
+
+#include "file.hpp"
+#include "file_cache.hpp"
+
+namespace Sass {
+
+  // names are compared like the file system does
+  // (default file systems on mac are case insensitive)
+  static std::string fold_name(std::string name)
+  {
+    #ifdef __APPLE__
+      for (size_t i = 0; i < name.size(); ++i)
+        name[i] = tolower(name[i]);
+    #endif
+    return name;
+  }
+
+  File_Cache::File_Cache()
+  : mutex(), dirs(), refcount(1), hits(0), misses(0)
+  { }
+
+  File_Cache::~File_Cache()
+  { }
+
+  File_Cache* File_Cache::retain()
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    ++ refcount;
+    return this;
+  }
+
+  // returns true if the last reference was dropped
+  // caller is then responsible to delete the object
+  bool File_Cache::release()
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    return -- refcount == 0;
+  }
+
+  File_Cache::Listing File_Cache::read_dir(const std::string& dir)
+  {
+    Listing listing;
+    #ifndef _WIN32
+      DIR* handle = opendir(dir.c_str());
+      if (handle == 0) return listing;
+      while (struct dirent* entry = readdir(handle)) {
+        Kind kind = IS_UNKNOWN;
+        #ifdef _DIRENT_HAVE_D_TYPE
+          // symlinks need to be followed later
+          if (entry->d_type == DT_REG) kind = IS_FILE;
+          else if (entry->d_type == DT_DIR) kind = IS_OTHER;
+        #endif
+        listing[fold_name(entry->d_name)] = kind;
+      }
+      closedir(handle);
+    #endif
+    return listing;
+  }
+
+  bool File_Cache::file_exists(const std::string& abs_path)
+  {
+    #ifdef _WIN32
+      // listings are not implemented for windows yet
+      return File::file_exists(abs_path);
+    #else
+      std::string dir(File::dir_name(abs_path));
+      std::string name(fold_name(File::base_name(abs_path)));
+      std::unique_lock<std::mutex> lock(mutex);
+      auto it = dirs.find(dir);
+      if (it == dirs.end()) {
+        // read the directory outside of the lock
+        lock.unlock();
+        Listing listing(read_dir(dir));
+        lock.lock();
+        ++ misses;
+        it = dirs.insert(std::make_pair(dir, listing)).first;
+        auto entry = it->second.find(name);
+        if (entry == it->second.end()) return false;
+        if (entry->second != IS_UNKNOWN) return entry->second == IS_FILE;
+      }
+      else {
+        auto entry = it->second.find(name);
+        if (entry == it->second.end()) { ++ hits; return false; }
+        if (entry->second != IS_UNKNOWN) { ++ hits; return entry->second == IS_FILE; }
+      }
+      // type not reported by readdir (or a symlink)
+      lock.unlock();
+      bool exists = File::file_exists(abs_path);
+      lock.lock();
+      ++ misses;
+      // the listing may have been dropped meanwhile
+      it = dirs.find(dir);
+      if (it != dirs.end()) {
+        auto entry = it->second.find(name);
+        if (entry != it->second.end()) entry->second = exists ? IS_FILE : IS_OTHER;
+      }
+      return exists;
+    #endif
+  }
+
+  void File_Cache::invalidate(const std::string& abs_path)
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    // the path may be a directory itself
+    dirs.erase(abs_path + "/");
+    dirs.erase(File::dir_name(abs_path));
+  }
+
+  void File_Cache::clear()
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    dirs.clear();
+  }
+
+  size_t File_Cache::size()
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    return dirs.size();
+  }
+
+  size_t File_Cache::get_hits()
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    return hits;
+  }
+
+  size_t File_Cache::get_misses()
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    return misses;
+  }
+
+}
@@ -0,0 +1,54 @@
+#ifndef SASS_FILE_CACHE_H
+#define SASS_FILE_CACHE_H
+
+#include <map>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace Sass {
+
+  // Thread safe store for directory listings.
+  // Import resolution probes many candidate names in
+  // every include path. Each directory is read once and
+  // the probes are answered from memory afterwards. The
+  // cache does not notice changes on the file system on
+  // its own, changed paths must be invalidated by the user.
+  class File_Cache {
+    private:
+      // what a directory entry is known to be
+      enum Kind { IS_FILE, IS_OTHER, IS_UNKNOWN };
+      // entries of one directory (empty if unreadable)
+      typedef std::unordered_map<std::string, Kind> Listing;
+      std::mutex mutex;
+      std::map<std::string, Listing> dirs;
+      size_t refcount;
+      size_t hits;
+      size_t misses;
+    public:
+      File_Cache();
+      virtual ~File_Cache();
+      // reference counting for shared ownership
+      File_Cache* retain();
+      bool release();
+      // test if absolute path exists and is a file
+      bool file_exists(const std::string& abs_path);
+      // drop the listings of the path and its directory
+      void invalidate(const std::string& abs_path);
+      // drop all listings
+      void clear();
+      // statistics (hits are saved stat calls)
+      size_t size();
+      size_t get_hits();
+      size_t get_misses();
+    private:
+      // read a directory from disk
+      static Listing read_dir(const std::string& dir);
+  };
+
+}
+
+// C-API handle for the directory listing cache
+struct Sass_File_Cache : Sass::File_Cache { };
+
+#endif
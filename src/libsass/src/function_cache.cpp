@@ -0,0 +1,103 @@
+#include "sass.hpp"
+#include <functional>
+
+#include "ast.hpp"
+#include "function_cache.hpp"
+
+namespace Sass {
+
+  // results kept before the cache is emptied
+  static const size_t MAX_RESULTS = 1 << 16;
+
+  Function_Cache::Function_Cache()
+  : mutex(), results(), refcount(1), hits(0), misses(0)
+  { }
+
+  Function_Cache::~Function_Cache()
+  {
+    clear();
+  }
+
+  Function_Cache* Function_Cache::retain()
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    ++ refcount;
+    return this;
+  }
+
+  // returns true if the last reference was dropped
+  // caller is then responsible to delete the object
+  bool Function_Cache::release()
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    return -- refcount == 0;
+  }
+
+  Function_Cache::Key Function_Cache::make_key(const std::string& signature, const std::vector<Expression_Obj>& args)
+  {
+    Key key;
+    key.hash = std::hash<std::string>()(signature);
+    key.repr = signature;
+    for (const Expression_Obj& arg : args) {
+      hash_combine(key.hash, arg->hash());
+      // the type tells apart values that print the same
+      key.repr += '\0';
+      key.repr += arg->type();
+      key.repr += ':';
+      key.repr += arg->to_string({ NESTED, 10 });
+    }
+    return key;
+  }
+
+  union Sass_Value* Function_Cache::get(const Key& key)
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = results.find(key);
+    if (it == results.end()) {
+      ++ misses;
+      return 0;
+    }
+    ++ hits;
+    return sass_clone_value(it->second);
+  }
+
+  void Function_Cache::put(const Key& key, const union Sass_Value* result)
+  {
+    if (sass_value_is_error(result) || sass_value_is_warning(result)) return;
+    union Sass_Value* copy = sass_clone_value(result);
+    std::lock_guard<std::mutex> lock(mutex);
+    if (results.size() >= MAX_RESULTS) {
+      for (auto& entry : results) sass_delete_value(entry.second);
+      results.clear();
+    }
+    auto inserted = results.insert(std::make_pair(key, copy));
+    // another context stored the same call meanwhile
+    if (!inserted.second) sass_delete_value(copy);
+  }
+
+  void Function_Cache::clear()
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    for (auto& entry : results) sass_delete_value(entry.second);
+    results.clear();
+  }
+
+  size_t Function_Cache::size()
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    return results.size();
+  }
+
+  size_t Function_Cache::get_hits()
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    return hits;
+  }
+
+  size_t Function_Cache::get_misses()
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    return misses;
+  }
+
+}
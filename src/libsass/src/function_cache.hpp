@@ -0,0 +1,63 @@
+#ifndef SASS_FUNCTION_CACHE_H
+#define SASS_FUNCTION_CACHE_H
+
+#include <mutex>
+#include <string>
+#include <vector>
+#include <unordered_map>
+
+#include "sass/values.h"
+#include "ast_fwd_decl.hpp"
+
+namespace Sass {
+
+  // Thread safe store for results of pure custom functions.
+  // Calls are keyed by the function signature and the structural
+  // hash of the arguments. The inspected arguments are compared
+  // too, so a hash collision never returns a wrong result. Results
+  // are kept as C values, which can be used by contexts on other
+  // threads. Everything is dropped once the cache grows too big.
+  class Function_Cache {
+    public:
+      // identifies one call of a function
+      struct Key {
+        size_t hash;
+        std::string repr;
+        bool operator==(const Key& rhs) const
+        { return hash == rhs.hash && repr == rhs.repr; }
+      };
+      struct Hash_Key {
+        size_t operator()(const Key& key) const { return key.hash; }
+      };
+    private:
+      std::mutex mutex;
+      std::unordered_map<Key, union Sass_Value*, Hash_Key> results;
+      size_t refcount;
+      size_t hits;
+      size_t misses;
+    public:
+      Function_Cache();
+      virtual ~Function_Cache();
+      // reference counting for shared ownership
+      Function_Cache* retain();
+      bool release();
+      // key for calling the function with the given arguments
+      static Key make_key(const std::string& signature, const std::vector<Expression_Obj>& args);
+      // copy of the stored result or null (caller must free it)
+      union Sass_Value* get(const Key& key);
+      // store a copy of the result (errors are not stored)
+      void put(const Key& key, const union Sass_Value* result);
+      // drop all results
+      void clear();
+      // statistics (hits are calls that did not run the function)
+      size_t size();
+      size_t get_hits();
+      size_t get_misses();
+  };
+
+}
+
+// C-API handle for the function result cache
+struct Sass_Function_Cache : Sass::Function_Cache { };
+
+#endif
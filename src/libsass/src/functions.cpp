@@ -1807,7 +1807,7 @@ namespace Sass {
 
       std::string name = Util::normalize_underscores(unquote(ss->value()));
 
-      if(d_env.has_global(name+"[f]")) {
+      if(d_env.has_global(name+"[f]") || built_in_function(ctx, name+"[f]")) {
         return SASS_MEMORY_NEW(Boolean, pstate, true);
       }
       else {
@@ -2223,11 +2223,13 @@ namespace Sass {
       }
 
 
-      if (!d_env.has_global(full_name)) {
+      Definition_Ptr def = d_env.has_global(full_name)
+        ? Cast<Definition>(d_env[full_name])
+        : built_in_function(ctx, full_name);
+      if (!def) {
         error("Function not found: " + name, pstate, traces);
       }
 
-      Definition_Ptr def = Cast<Definition>(d_env[full_name]);
       return SASS_MEMORY_NEW(Function, pstate, def, false);
     }
   }
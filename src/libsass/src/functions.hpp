@@ -18,6 +18,10 @@ namespace Sass {
   Definition_Ptr make_native_function(Signature, Native_Function, Context& ctx);
   Definition_Ptr make_c_function(Sass_Function_Entry c_func, Context& ctx);
 
+  // lookup in the process wide table of built-in functions
+  // keys are the same as in the environment ("name[f]" + arity)
+  Definition_Ptr built_in_function(Context& ctx, const EnvKey& key);
+
   std::string function_name(Signature);
 
   namespace Functions {
@@ -5,6 +5,24 @@
 #include "lexer.hpp"
 #include "constants.hpp"
 
+#if defined(__SSE2__) && defined(__GNUC__)
+#include <emmintrin.h>
+#include <stdint.h>
+#define SASS_SSE2_SCAN
+// the scan reads whole aligned blocks
+// around the terminating null byte
+#if defined(__SANITIZE_ADDRESS__)
+#define SASS_NO_ASAN __attribute__((no_sanitize_address))
+#elif defined(__has_feature)
+#if __has_feature(address_sanitizer)
+#define SASS_NO_ASAN __attribute__((no_sanitize_address))
+#endif
+#endif
+#ifndef SASS_NO_ASAN
+#define SASS_NO_ASAN
+#endif
+#endif
+
 
 namespace Sass {
   using namespace Constants;
@@ -25,6 +43,30 @@ namespace Sass {
     const char* kwd_minus(const char* src) { return exactly<'-'>(src); };
     const char* kwd_slash(const char* src) { return exactly<'/'>(src); };
 
+    //####################################
+    // CHARACTER CLASS TABLE
+    //####################################
+
+    // flags of `Char_Class` for every byte
+    const unsigned char char_classes[256] = {
+       0,  0,  0,  0,  0,  0,  0,  0,  0,  1,  1,  1,  1,  1,  0,  0, // 0x00
+       0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0, // 0x10
+       1,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0, 16,  0,  0, // 0x20
+      26, 26, 26, 26, 26, 26, 26, 26, 26, 26,  0,  0,  0,  0,  0,  0, // 0x30
+       0, 28, 28, 28, 28, 28, 28, 20, 20, 20, 20, 20, 20, 20, 20, 20, // 0x40
+      20, 20, 20, 20, 20, 20, 20, 20, 20, 20, 20,  0,  0,  0,  0, 16, // 0x50
+       0, 28, 28, 28, 28, 28, 28, 20, 20, 20, 20, 20, 20, 20, 20, 20, // 0x60
+      20, 20, 20, 20, 20, 20, 20, 20, 20, 20, 20,  0,  0,  0,  0,  0, // 0x70
+      16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, // 0x80
+      16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, // 0x90
+      16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, // 0xa0
+      16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, // 0xb0
+      16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, // 0xc0
+      16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, // 0xd0
+      16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, // 0xe0
+      16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16  // 0xf0
+    };
+
     //####################################
     // implement some function that do exist in the standard
     // but those are locale aware which brought some trouble
@@ -33,20 +75,17 @@ namespace Sass {
 
     bool is_alpha(const char& chr)
     {
-      return unsigned(chr - 'A') <= 'Z' - 'A' ||
-             unsigned(chr - 'a') <= 'z' - 'a';
+      return char_class(chr) & CC_ALPHA;
     }
 
     bool is_space(const char& chr)
     {
-      // adapted the technique from is_alpha
-      return chr == ' ' || unsigned(chr - '\t') <= '\r' - '\t';
+      return char_class(chr) & CC_SPACE;
     }
 
     bool is_digit(const char& chr)
     {
-      // adapted the technique from is_alpha
-      return unsigned(chr - '0') <= '9' - '0';
+      return char_class(chr) & CC_DIGIT;
     }
 
     bool is_number(const char& chr)
@@ -57,10 +96,7 @@ namespace Sass {
 
     bool is_xdigit(const char& chr)
     {
-      // adapted the technique from is_alpha
-      return unsigned(chr - '0') <= '9' - '0' ||
-             unsigned(chr - 'a') <= 'f' - 'a' ||
-             unsigned(chr - 'A') <= 'F' - 'A';
+      return char_class(chr) & CC_XDIGIT;
     }
 
     bool is_punct(const char& chr)
@@ -71,7 +107,7 @@ namespace Sass {
 
     bool is_alnum(const char& chr)
     {
-      return is_alpha(chr) || is_digit(chr);
+      return char_class(chr) & (CC_ALPHA | CC_DIGIT);
     }
 
     // check if char is outside ascii range
@@ -114,7 +150,7 @@ namespace Sass {
     bool is_character(const char& chr)
     {
       // valid alpha, numeric or unicode char (plus hyphen)
-      return is_alnum(chr) || is_unicode(chr) || chr == '-';
+      return (char_class(chr) & CC_WORD) && chr != '_';
     }
 
     //####################################
@@ -136,13 +172,13 @@ namespace Sass {
     const char* escapable_character(const char* src) { return is_escapable_character(*src) ? src + 1 : 0; }
 
     // Match multiple ctype characters.
-    const char* spaces(const char* src) { return one_plus<space>(src); }
-    const char* digits(const char* src) { return one_plus<digit>(src); }
+    const char* spaces(const char* src) { const char* p = skip_class(src, CC_SPACE); return p == src ? 0 : p; }
+    const char* digits(const char* src) { const char* p = skip_class(src, CC_DIGIT); return p == src ? 0 : p; }
     const char* hyphens(const char* src) { return one_plus<hyphen>(src); }
 
     // Whitespace handling.
     const char* no_spaces(const char* src) { return negate< space >(src); }
-    const char* optional_spaces(const char* src) { return zero_plus< space >(src); }
+    const char* optional_spaces(const char* src) { return skip_class(src, CC_SPACE); }
 
     // Match any single character.
     const char* any_char(const char* src) { return *src ? src + 1 : src; }
@@ -177,5 +213,57 @@ namespace Sass {
       return *src == 0 ? src : 0;
     }
 
+    //####################################
+    // BULK SCANNERS
+    //####################################
+
+    // Skip over all chars of the given classes
+    const char* skip_class(const char* src, unsigned char classes)
+    {
+      // the null byte has no class
+      while (char_class(*src) & classes) ++ src;
+      return src;
+    }
+
+    #ifdef SASS_SSE2_SCAN
+
+    // Skip to the first of the given chars or the null byte.
+    // Compares 16 bytes at once; the loads are aligned, so they
+    // never cross a page boundary after the terminating null byte.
+    SASS_NO_ASAN
+    const char* skip_until(const char* src, char a, char b, char c)
+    {
+      const __m128i zero = _mm_setzero_si128();
+      const __m128i va = _mm_set1_epi8(a);
+      const __m128i vb = _mm_set1_epi8(b);
+      const __m128i vc = _mm_set1_epi8(c);
+      size_t offset = reinterpret_cast<uintptr_t>(src) & 15;
+      const __m128i* block = reinterpret_cast<const __m128i*>(src - offset);
+      // ignore the bytes of the first block before `src`
+      unsigned int mask = 0xffff << offset;
+      while (true) {
+        __m128i chunk = _mm_load_si128(block);
+        __m128i hits = _mm_or_si128(
+          _mm_or_si128(_mm_cmpeq_epi8(chunk, zero), _mm_cmpeq_epi8(chunk, va)),
+          _mm_or_si128(_mm_cmpeq_epi8(chunk, vb), _mm_cmpeq_epi8(chunk, vc))
+        );
+        mask &= static_cast<unsigned int>(_mm_movemask_epi8(hits));
+        if (mask) return reinterpret_cast<const char*>(block) + __builtin_ctz(mask);
+        mask = 0xffff;
+        ++ block;
+      }
+    }
+
+    #else
+
+    // Skip to the first of the given chars or the null byte.
+    const char* skip_until(const char* src, char a, char b, char c)
+    {
+      while (*src && *src != a && *src != b && *src != c) ++ src;
+      return src;
+    }
+
+    #endif
+
   }
 }
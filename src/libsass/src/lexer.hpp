@@ -24,6 +24,20 @@ namespace Sass {
     // BASIC CLASS MATCHERS
     //####################################
 
+    // Character classes of all bytes (bit flags).
+    // A word char is alnum, hyphen, underscore or unicode.
+    enum Char_Class {
+      CC_SPACE = 1,
+      CC_DIGIT = 2,
+      CC_ALPHA = 4,
+      CC_XDIGIT = 8,
+      CC_WORD = 16
+    };
+    extern const unsigned char char_classes[256];
+    inline unsigned char char_class(char chr) {
+      return char_classes[static_cast<unsigned char>(chr)];
+    }
+
     // These are locale independant
     bool is_space(const char& src);
     bool is_alpha(const char& src);
@@ -61,6 +75,14 @@ namespace Sass {
     const char* no_spaces(const char* src);
     const char* optional_spaces(const char* src);
 
+    // Bulk scanners (they never fail, a position is returned
+    // even if no char was skipped). They are used by the hot
+    // matchers in place of the byte by byte combinators.
+    // Skip over all chars of the given classes.
+    const char* skip_class(const char* src, unsigned char classes);
+    // Skip to the first of the given chars or the null byte.
+    const char* skip_until(const char* src, char a, char b = 0, char c = 0);
+
     // Match any single character (/./).
     const char* any_char(const char* src);
 
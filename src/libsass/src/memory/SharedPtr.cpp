@@ -31,13 +31,16 @@ namespace Sass {
 
   bool SharedObj::taint = false;
 
+  thread_local size_t SharedObj::allocations = 0;
+
   SharedObj::SharedObj()
-  : detached(false)
+  : detached(false), frozen(false)
     #ifdef DEBUG_SHARED_PTR
     , dbg(false)
     #endif
   {
     refcounter = 0;
+    ++ allocations;
     #ifdef DEBUG_SHARED_PTR
       if (taint) all.push_back(this);
     #endif
@@ -53,7 +56,7 @@ namespace Sass {
   };
 
   void SharedPtr::decRefCount() {
-    if (node) {
+    if (node && !node->frozen) {
       -- node->refcounter;
       #ifdef DEBUG_SHARED_PTR
         if (node->dbg)  std::cerr << "- " << node << " X " << node->refcounter << " (" << this << ") " << "\n";
@@ -71,7 +74,7 @@ namespace Sass {
   }
 
   void SharedPtr::incRefCount() {
-    if (node) {
+    if (node && !node->frozen) {
       ++ node->refcounter;
       node->detached = false;
       #ifdef DEBUG_SHARED_PTR
@@ -51,10 +51,15 @@ namespace Sass {
     long refcounter;
     // long refcount;
     bool detached;
+    // shared across threads, never
+    // counted nor deallocated
+    bool frozen;
     #ifdef DEBUG_SHARED_PTR
       bool dbg;
     #endif
   public:
+    // number of objects created on this thread
+    static thread_local size_t allocations;
     #ifdef DEBUG_SHARED_PTR
       static void dumpMemLeaks();
       SharedObj* trace(std::string file, size_t line) {
@@ -78,6 +83,12 @@ namespace Sass {
     static void setTaint(bool val) {
       taint = val;
     }
+    void freeze() {
+      frozen = true;
+    }
+    bool is_frozen() const {
+      return frozen;
+    }
     virtual ~SharedObj();
     long getRefCount() {
       return refcounter;
@@ -1,13 +1,22 @@
 #include "sass.hpp"
+#include <cstring>
+#include <algorithm>
 #include "ast.hpp"
 #include "output.hpp"
 
 namespace Sass {
 
+  // bytes collected before a chunk is written to the sink
+  static const size_t STREAM_CHUNK_SIZE = 64 * 1024;
+
   Output::Output(Sass_Output_Options& opt)
   : Inspect(Emitter(opt)),
     charset(""),
-    top_nodes(0)
+    top_nodes(0),
+    sink(0),
+    sink_cookie(0),
+    utf8_sources(false),
+    streamed(false)
   {}
 
   Output::~Output() { }
@@ -42,7 +51,7 @@ namespace Sass {
     throw Exception::InvalidValue({}, *m);
   }
 
-  OutputBuffer Output::get_buffer(void)
+  void Output::prepend_top_nodes(void)
   {
 
     Emitter emitter(opt);
@@ -53,39 +62,116 @@ namespace Sass {
       top_nodes[i]->perform(&inspect);
       inspect.append_mandatory_linefeed();
     }
+    top_nodes.clear();
 
     // flush scheduled outputs
     // maybe omit semicolon if possible
     inspect.finalize(wbuf.buffer.size() == 0);
     // prepend buffer on top
     prepend_output(inspect.output());
-    // make sure we end with a linefeed
-    if (!ends_with(wbuf.buffer, opt.linefeed)) {
-      // if the output is not completely empty
-      if (!wbuf.buffer.empty()) append_string(opt.linefeed);
-    }
+
+  }
+
+  void Output::prepend_charset(bool force)
+  {
 
     // search for unicode char
     for(const char& chr : wbuf.buffer) {
       // skip all ascii chars
       // static cast to unsigned to handle `char` being signed / unsigned
       if (static_cast<unsigned>(chr) < 128) continue;
-      // declare the charset
+      force = true;
+      // abort search
+      break;
+    }
+
+    // declare the charset
+    if (force) {
       if (output_style() != COMPRESSED)
         charset = "@charset \"UTF-8\";"
                 + std::string(opt.linefeed);
       else charset = "\xEF\xBB\xBF";
-      // abort search
-      break;
     }
 
     // add charset as first line, before comments and imports
     if (!charset.empty()) prepend_string(charset);
 
+  }
+
+  OutputBuffer Output::get_buffer(void)
+  {
+
+    // already written with the first chunk
+    if (!streamed) prepend_top_nodes();
+    // make sure we end with a linefeed
+    if (!ends_with(wbuf.buffer, opt.linefeed)) {
+      // if the output is not completely empty
+      if (!wbuf.buffer.empty()) append_string(opt.linefeed);
+    }
+    if (!streamed) prepend_charset(false);
+
     return wbuf;
 
   }
 
+  void Output::stream_to(Sass_Output_Sink sink, void* cookie, bool utf8_sources)
+  {
+    this->sink = sink;
+    this->sink_cookie = cookie;
+    this->utf8_sources = utf8_sources;
+  }
+
+  // true if the statement is an import or contains one
+  // (they are all hoisted to the top of the output)
+  static bool contains_import(Statement_Ptr stm)
+  {
+    if (Cast<Import>(stm)) return true;
+    if (Has_Block_Ptr parent = Cast<Has_Block>(stm)) {
+      if (Block_Ptr b = parent->block()) {
+        for (size_t i = 0, L = b->length(); i < L; ++i) {
+          if (contains_import(b->at(i))) return true;
+        }
+      }
+    }
+    return false;
+  }
+
+  void Output::operator()(Block_Ptr b)
+  {
+    if (!sink || !b->is_root()) return Inspect::operator()(b);
+
+    // chunks are written once no hoisted node can follow
+    size_t hoist_until = 0;
+    for (size_t i = 0, L = b->length(); i < L; ++i) {
+      if (contains_import(b->at(i))) hoist_until = i + 1;
+    }
+
+    if (output_style() == NESTED) indentation += b->tabs();
+    for (size_t i = 0, L = b->length(); i < L; ++i) {
+      (*b)[i]->perform(this);
+      if (i + 1 >= hoist_until) flush_stream();
+    }
+    if (output_style() == NESTED) indentation -= b->tabs();
+  }
+
+  void Output::flush_stream(void)
+  {
+    // keep the tail, the emitter looks back at the last
+    // characters (i.e. for spaces or the final linefeed)
+    size_t keep = std::max<size_t>(strlen(opt.linefeed), 1);
+    if (wbuf.buffer.size() < keep + STREAM_CHUNK_SIZE) return;
+
+    if (!streamed) {
+      prepend_top_nodes();
+      prepend_charset(utf8_sources);
+      streamed = true;
+    }
+
+    size_t size = wbuf.buffer.size() - keep;
+    sink(wbuf.buffer.data(), size, sink_cookie);
+    wbuf.buffer.erase(0, size);
+  }
+
   void Output::operator()(Comment_Ptr c)
   {
     std::string txt = c->text()->to_string(opt);
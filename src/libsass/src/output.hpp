@@ -4,6 +4,7 @@
 #include <string>
 #include <vector>
 
+#include "sass/context.h"
 #include "util.hpp"
 #include "inspect.hpp"
 #include "operation.hpp"
@@ -30,9 +31,29 @@ namespace Sass {
     std::string charset;
     std::vector<AST_Node_Ptr> top_nodes;
 
+    // receives finished top-level blocks
+    Sass_Output_Sink sink;
+    void* sink_cookie;
+    // declare the charset once streaming starts
+    bool utf8_sources;
+    // true once the first chunk was written
+    bool streamed;
+
+    void prepend_top_nodes(void);
+    void prepend_charset(bool force);
+    void flush_stream(void);
+
   public:
     OutputBuffer get_buffer(void);
 
+    // Write the output to the sink while it is generated.
+    // The charset can not be prepended anymore once the
+    // first chunk is out, so it is declared if any source
+    // contains non-ascii characters (`utf8_sources`).
+    void stream_to(Sass_Output_Sink sink, void* cookie, bool utf8_sources);
+
+    virtual void operator()(Block_Ptr);
+
     virtual void operator()(Map_Ptr);
     virtual void operator()(Ruleset_Ptr);
     virtual void operator()(Supports_Block_Ptr);
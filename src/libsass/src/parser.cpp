@@ -21,6 +21,7 @@
 // Another case with delayed values are colors. In compressed mode
 // only processed values get compressed (other are left as written).
 
+#include <cstdint>
 #include <cstdlib>
 #include <iostream>
 #include <vector>
@@ -30,6 +31,41 @@ namespace Sass {
   using namespace Constants;
   using namespace Prelexer;
 
+  Lookahead_Memo::Lookahead_Memo()
+  : stats()
+  {
+    for (size_t i = 0; i < SLOTS; ++i) {
+      slots[i].production = 0;
+      slots[i].position = 0;
+      slots[i].result = 0;
+    }
+  }
+
+  const char* Lookahead_Memo::probe(Prelexer::prelexer mx, const char* src)
+  {
+    Slot& slot = slots[reinterpret_cast<uintptr_t>(src) % SLOTS];
+    ++ stats.probes;
+    if (slot.production == mx && slot.position == src) {
+      ++ stats.hits;
+      if (slot.result) stats.saved += slot.result - src;
+      return slot.result;
+    }
+    const char* result = mx(src);
+    if (result) stats.scanned += result - src;
+    slot.production = mx;
+    slot.position = src;
+    slot.result = result;
+    return result;
+  }
+
+  void Lookahead_Memo::add_stats(Profile::Lookaheads& profile) const
+  {
+    profile.probes += stats.probes;
+    profile.hits += stats.hits;
+    profile.scanned += stats.scanned;
+    profile.saved += stats.saved;
+  }
+
   Parser Parser::from_c_str(const char* beg, Context& ctx, Backtraces traces, ParserState pstate, const char* source)
   {
     pstate.offset.column = 0;
@@ -113,7 +149,7 @@ namespace Sass {
     Block_Obj root = SASS_MEMORY_NEW(Block, pstate, 0, true);
 
     // check seems a bit esoteric but works
-    if (ctx.resources.size() == 1) {
+    if (!prefetcher && ctx.resources.size() == 1) {
       // apply headers only on very first include
       ctx.apply_custom_headers(root, path, pstate);
     }
@@ -372,6 +408,10 @@ namespace Sass {
       if (location.second) {
         imp->urls().push_back(location.second);
       }
+      // only resolve the import on a prefetch worker
+      else if (prefetcher) {
+        prefetcher->import_url(sheet, imp, location.first, path);
+      }
       // check if custom importers want to take over the handling
       else if (!ctx.call_importers(unquote(location.first), path, pstate, imp)) {
         // nobody wants it, so we do our import
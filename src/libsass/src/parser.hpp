@@ -9,6 +9,7 @@
 #include "context.hpp"
 #include "position.hpp"
 #include "prelexer.hpp"
+#include "prefetcher.hpp"
 
 #ifndef MAX_NESTING
 // Note that this limit is not an exact science
@@ -30,6 +31,28 @@ struct Lookahead {
 
 namespace Sass {
 
+  // Bounded memo of the results of expensive productions, keyed by
+  // the production and the position it was probed at (packrat style).
+  // A production is mostly probed again right before it is lexed (a
+  // peek before the lex), so a few direct mapped slots are enough.
+  // Results only depend on the source, they never become stale.
+  class Lookahead_Memo {
+    public:
+      Lookahead_Memo();
+      // returns the memoized result or runs the production
+      const char* probe(Prelexer::prelexer mx, const char* src);
+      // adds the counters to the profile of the context
+      void add_stats(Profile::Lookaheads& stats) const;
+    private:
+      static const size_t SLOTS = 8;
+      struct Slot {
+        Prelexer::prelexer production;
+        const char* position;
+        const char* result;
+      } slots[SLOTS];
+      Profile::Lookaheads stats;
+  };
+
   class Parser : public ParserState {
   public:
 
@@ -48,13 +71,19 @@ namespace Sass {
     Backtraces traces;
     size_t indentation;
     size_t nestings;
+    // set when parsing on a prefetch worker
+    Prefetcher* prefetcher;
+    Cached_Sheet* sheet;
+    // results of expensive lookaheads
+    Lookahead_Memo memo;
 
     Token lexed;
 
     Parser(Context& ctx, const ParserState& pstate, Backtraces traces)
     : ParserState(pstate), ctx(ctx), block_stack(), stack(0), last_media_block(),
       source(0), position(0), end(0), before_token(pstate), after_token(pstate),
-      pstate(pstate), traces(traces), indentation(0), nestings(0)
+      pstate(pstate), traces(traces), indentation(0), nestings(0),
+      prefetcher(0), sheet(0), memo()
     { 
       stack.push_back(Scope::Root);
     }
@@ -113,13 +142,29 @@ namespace Sass {
 
     }
 
+    // run the prelexer, expensive productions that are
+    // probed repeatedly at the same position are memoized
+    template <Prelexer::prelexer mx>
+    const char* probe(const char* src)
+    {
+      using namespace Prelexer;
+      if (mx == static_value ||
+          mx == re_selector_list ||
+          mx == re_pseudo_selector ||
+          mx == pseudo_not
+      ) {
+        return memo.probe(mx, src);
+      }
+      return mx(src);
+    }
+
     // match will not skip over space, tabs and line comment
     // return the position where the lexer match will occur
     template <Prelexer::prelexer mx>
     const char* match(const char* start = 0)
     {
       // match the given prelexer
-      return mx(position);
+      return probe< mx >(position);
     }
 
     // peek will only skip over space, tabs and line comment
@@ -133,7 +178,7 @@ namespace Sass {
       const char* it_before_token = sneak < mx >(start);
 
       // match the given prelexer
-      const char* match = mx(it_before_token);
+      const char* match = probe< mx >(it_before_token);
 
       // check if match is in valid range
       return match <= end ? match : 0;
@@ -162,7 +207,7 @@ namespace Sass {
       if (lazy) it_before_token = sneak < mx >(position);
 
       // now call matcher to get position after token
-      const char* it_after_token = mx(it_before_token);
+      const char* it_after_token = probe< mx >(it_before_token);
 
       // check if match is in valid range
       if (it_after_token > end) return 0;
@@ -0,0 +1,126 @@
+#include "sass.hpp"
+#include <thread>
+#include <vector>
+#include <stdexcept>
+
+#include "ast.hpp"
+#include "util.hpp"
+#include "parser.hpp"
+#include "context.hpp"
+#include "prefetcher.hpp"
+
+namespace Sass {
+
+  Prefetcher::Prefetcher(Context& ctx, size_t threads)
+  : ctx(ctx), threads(threads), mutex(), cond(),
+    queue(), seen(), busy(0)
+  { }
+
+  void Prefetcher::run(Cached_Sheet* entry)
+  {
+    // the entry counts as busy until its imports are known
+    busy = 1;
+    std::vector<std::thread> workers;
+    for (size_t i = 1; i < threads; ++i) {
+      workers.push_back(std::thread(&Prefetcher::work, this));
+    }
+    if (entry->root.isNull()) parse(entry);
+    else for (const Cached_Import& imp : entry->imports) enqueue(imp.include);
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      -- busy;
+    }
+    cond.notify_all();
+    // help out until the queue is drained
+    work();
+    for (std::thread& worker : workers) worker.join();
+  }
+
+  void Prefetcher::work()
+  {
+    std::unique_lock<std::mutex> lock(mutex);
+    for (;;) {
+      // more work may come from the busy ones
+      while (queue.empty() && busy > 0) cond.wait(lock);
+      if (queue.empty()) break;
+      Include inc(queue.front());
+      queue.pop_front();
+      ++ busy;
+      lock.unlock();
+      prefetch(inc);
+      lock.lock();
+      -- busy;
+      cond.notify_all();
+    }
+  }
+
+  void Prefetcher::enqueue(const Include& inc)
+  {
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      if (!seen.insert(inc.abs_path).second) return;
+      queue.push_back(inc);
+    }
+    cond.notify_one();
+  }
+
+  // parse into the leased sheet, imports are only
+  // resolved and queued (returns false on errors)
+  bool Prefetcher::parse(Cached_Sheet* sheet)
+  {
+    try {
+      ParserState pstate(sheet->path, sheet->contents, 0);
+      Parser p(Parser::from_c_str(sheet->contents, ctx, Backtraces(), pstate));
+      p.prefetcher = this;
+      p.sheet = sheet;
+      sheet->root = p.parse();
+      return true;
+    }
+    catch (...) {
+      // the context will parse it again
+      sheet->imports.clear();
+      sheet->root = {};
+      return false;
+    }
+  }
+
+  void Prefetcher::prefetch(const Include& inc)
+  {
+    Cached_Sheet* sheet = 0;
+    try {
+      sheet = ctx.acquire_sheet(inc.abs_path);
+    }
+    catch (...) {
+      return;
+    }
+    if (sheet == 0) {
+      char* contents = File::read_file(inc.abs_path, ctx.c_options.mmap_sources);
+      if (contents == 0) return;
+      // the cache takes over the buffer
+      sheet = ctx.sheet_cache->create(File::rel2abs(inc.abs_path, ".", ctx.CWD), inc.abs_path, ctx.sheet_env, contents);
+      if (!parse(sheet)) {
+        ctx.sheet_cache->release(sheet);
+        return;
+      }
+    }
+    else {
+      // reused sheet, its imports may have changed
+      for (const Cached_Import& imp : sheet->imports) enqueue(imp.include);
+    }
+    std::lock_guard<std::mutex> lock(mutex);
+    ctx.prefetched_sheets[inc.abs_path] = sheet;
+  }
+
+  void Prefetcher::import_url(Cached_Sheet* sheet, Import_Ptr imp, const std::string& load_path, const std::string& ctx_path)
+  {
+    if (Context::add_css_import(imp, load_path)) return;
+    const Importer importer(unquote(load_path), ctx_path);
+    const std::vector<Include> resolved(ctx.find_includes(importer));
+    // ambiguous and missing imports are reported by the context
+    if (resolved.size() != 1) throw std::runtime_error("unresolved import");
+    sheet->imports.push_back(Cached_Import(importer, resolved[0], imp->pstate()));
+    imp->incs().push_back(resolved[0]);
+    enqueue(resolved[0]);
+  }
+
+}
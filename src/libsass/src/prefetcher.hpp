@@ -0,0 +1,53 @@
+#ifndef SASS_PREFETCHER_H
+#define SASS_PREFETCHER_H
+
+#include <set>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <condition_variable>
+
+#include "ast_fwd_decl.hpp"
+#include "sheet_cache.hpp"
+
+namespace Sass {
+
+  class Context;
+
+  // Parses the import tree of an entry sheet on worker threads.
+  // Workers only resolve and record the imports of each sheet,
+  // every newly found file is queued for the next free worker.
+  // Finished sheets are handed to the context after all workers
+  // joined, which then registers them in the same order as a
+  // serial parse would (see `Context::register_sheet`). A sheet
+  // that fails to parse is dropped, so the context parses it
+  // again itself and reports the error like it always does.
+  class Prefetcher {
+    private:
+      Context& ctx;
+      size_t threads;
+      std::mutex mutex;
+      std::condition_variable cond;
+      // includes waiting for a worker
+      std::deque<Include> queue;
+      // includes queued once already
+      std::set<std::string> seen;
+      // workers parsing right now
+      size_t busy;
+    public:
+      Prefetcher(Context& ctx, size_t threads);
+      // parse the entry sheet (if needed) and all
+      // its imports, blocks until all are done
+      void run(Cached_Sheet* entry);
+      // called by the parser for every `@import` url
+      void import_url(Cached_Sheet* sheet, Import_Ptr imp, const std::string& load_path, const std::string& ctx_path);
+    private:
+      void work();
+      void enqueue(const Include& inc);
+      bool parse(Cached_Sheet* sheet);
+      void prefetch(const Include& inc);
+  };
+
+}
+
+#endif
@@ -69,6 +69,16 @@ namespace Sass {
       false => string_re('"', '"'),
       true => string_re('', '"')
     */
+    // Skip the plain chars of a quoted string (anything but the
+    // quote, escapes, interpolants and the null byte) in bulk.
+    // Other alternatives never match in the middle of them.
+    template <char quote>
+    const char* quoted_string_chars(const char* src)
+    {
+      const char* p = skip_until(src, quote, '\\', '#');
+      return p == src ? 0 : p;
+    }
+
     extern const char string_double_negates[] = "\"\\#";
     const char* re_string_double_close(const char* src)
     {
@@ -76,6 +86,8 @@ namespace Sass {
         // valid chars
         zero_plus <
           alternatives <
+            // plain chars
+            quoted_string_chars < '"' >,
             // escaped char
             sequence <
               exactly <'\\'>,
@@ -111,6 +123,8 @@ namespace Sass {
         // valid chars
         zero_plus <
           alternatives <
+            // plain chars
+            quoted_string_chars < '"' >,
             // escaped char
             sequence <
               exactly <'\\'>,
@@ -145,6 +159,8 @@ namespace Sass {
         // valid chars
         zero_plus <
           alternatives <
+            // plain chars
+            quoted_string_chars < '\'' >,
             // escaped char
             sequence <
               exactly <'\\'>,
@@ -180,6 +196,8 @@ namespace Sass {
         // valid chars
         zero_plus <
           alternatives <
+            // plain chars
+            quoted_string_chars < '\'' >,
             // escaped char
             sequence <
               exactly <'\\'>,
@@ -263,27 +281,22 @@ namespace Sass {
     // Match a line comment (/.*?(?=\n|\r\n?|\Z)/.
     const char* line_comment(const char* src)
     {
-      return sequence<
-               exactly <
-                 slash_slash
-               >,
-               non_greedy<
-                 any_char,
-                 end_of_line
-               >
-             >(src);
+      if (src[0] != '/' || src[1] != '/') return 0;
+      return skip_until(src + 2, '\n', '\r');
     }
 
     // Match a block comment.
+    // Same as `delimited_by< slash_star, star_slash, false >`.
     const char* block_comment(const char* src)
     {
-      return sequence<
-               delimited_by<
-                 slash_star,
-                 star_slash,
-                 false
-               >
-             >(src);
+      if (src[0] != '/' || src[1] != '*') return 0;
+      src += 2;
+      while (true) {
+        src = skip_until(src, '*');
+        if (*src == 0) return 0;
+        if (src[1] == '/') return src + 2;
+        ++ src;
+      }
     }
     /* not use anymore - remove?
     const char* block_comment_prefix(const char* src) {
@@ -295,19 +308,36 @@ namespace Sass {
     }
     */
 
+    // Skip white-space and comments, same as
+    // `zero_plus< alternatives<spaces, line_comment, block_comment> >`
+    // (without block comments if `blocks` is false)
+    template <bool blocks>
+    const char* skip_css_comments(const char* src) {
+      const char* p;
+      while (true) {
+        src = skip_class(src, CC_SPACE);
+        if (*src != '/') return src;
+        if ((p = line_comment(src))) src = p;
+        else if (blocks && (p = block_comment(src))) src = p;
+        else return src;
+      }
+    }
+
     // Match zero plus white-space or line_comments
     const char* optional_css_whitespace(const char* src) {
-      return zero_plus< alternatives<spaces, line_comment> >(src);
+      return skip_css_comments<false>(src);
     }
     const char* css_whitespace(const char* src) {
-      return one_plus< alternatives<spaces, line_comment> >(src);
+      const char* p = skip_css_comments<false>(src);
+      return p == src ? 0 : p;
     }
     // Match optional_css_whitepace plus block_comments
     const char* optional_css_comments(const char* src) {
-      return zero_plus< alternatives<spaces, line_comment, block_comment> >(src);
+      return skip_css_comments<true>(src);
     }
     const char* css_comments(const char* src) {
-      return one_plus< alternatives<spaces, line_comment, block_comment> >(src);
+      const char* p = skip_css_comments<true>(src);
+      return p == src ? 0 : p;
     }
 
     // Match one backslash escaped char /\\./
@@ -367,15 +397,34 @@ namespace Sass {
              >(src);
     }
 
+    // Skip identifier chars (`zero_plus< identifier_alnum >`).
+    // Word chars are skipped by their class, only escapes
+    // and unicode ranges go through the combinators.
+    const char* skip_identifier_alnums(const char* src)
+    {
+      const char* p;
+      while (true) {
+        if (char_class(*src) & CC_WORD) {
+          if ((*src != 'u' && *src != 'U') || src[1] != '+') {
+            ++ src;
+            continue;
+          }
+        }
+        else if (*src != '\\') return src;
+        if (!(p = identifier_alnum(src))) return src;
+        src = p;
+      }
+    }
+
     // Match CSS identifiers.
+    // Same as `zero_plus< exactly<'-'> >`, `one_plus < identifier_alpha >`
+    // and `zero_plus < identifier_alnum >`, every identifier_alpha
+    // is also matched by identifier_alnum (word_boundary not needed)
     const char* identifier(const char* src)
     {
-      return sequence<
-               zero_plus< exactly<'-'> >,
-               one_plus < identifier_alpha >,
-               zero_plus < identifier_alnum >
-               // word_boundary not needed
-             >(src);
+      while (*src == '-') ++ src;
+      if (!(src = identifier_alpha(src))) return 0;
+      return skip_identifier_alnums(src);
     }
 
     const char* strict_identifier_alpha(const char* src)
@@ -448,7 +497,8 @@ namespace Sass {
 
     const char* identifier_alnums(const char* src)
     {
-      return one_plus< identifier_alnum >(src);
+      const char* p = skip_identifier_alnums(src);
+      return p == src ? 0 : p;
     }
 
     // Match number prefix ([\+\-]+)
@@ -514,6 +564,8 @@ namespace Sass {
         exactly <'\''>,
         zero_plus <
           alternatives <
+            // skip plain chars
+            quoted_string_chars < '\'' >,
             // skip escapes
             sequence <
               exactly < '\\' >,
@@ -538,6 +590,8 @@ namespace Sass {
         exactly <'"'>,
         zero_plus <
           alternatives <
+            // skip plain chars
+            quoted_string_chars < '"' >,
             // skip escapes
             sequence <
               exactly < '\\' >,
@@ -202,6 +202,9 @@ namespace Sass {
     const char* identifier(const char* src);
     const char* identifier_alpha(const char* src);
     const char* identifier_alnum(const char* src);
+    const char* identifier_alnums(const char* src);
+    // Skip identifier chars (never fails).
+    const char* skip_identifier_alnums(const char* src);
     const char* strict_identifier(const char* src);
     const char* strict_identifier_alpha(const char* src);
     const char* strict_identifier_alnum(const char* src);
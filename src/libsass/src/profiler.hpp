@@ -0,0 +1,84 @@
+#ifndef SASS_PROFILER_H
+#define SASS_PROFILER_H
+
+#include <chrono>
+#include <cstddef>
+
+#include "sass/context.h"
+#include "memory/SharedPtr.hpp"
+
+namespace Sass {
+
+  // number of entries in `Sass_Compiler_Phase`
+  const size_t PHASE_COUNT = SASS_PHASE_SOURCE_MAP + 1;
+
+  // Wall time and node allocations of the compile phases,
+  // how often and how long custom callbacks did run and
+  // how often the parser probed the same bytes again.
+  // Plain data, so it can be copied onto the C context.
+  struct Profile {
+    // milliseconds spent in each phase
+    double time[PHASE_COUNT];
+    // nodes created by each phase
+    size_t allocations[PHASE_COUNT];
+    // custom functions and importers (including headers)
+    struct Callbacks {
+      size_t calls;
+      double time;
+    } functions, importers;
+    // memoized parser lookaheads (bytes are scanned by
+    // the productions, saved ones were not scanned again)
+    struct Lookaheads {
+      size_t probes;
+      size_t hits;
+      size_t scanned;
+      size_t saved;
+    } lookaheads;
+  };
+
+  // milliseconds elapsed since the given time point
+  inline double elapsed_ms(std::chrono::steady_clock::time_point start)
+  {
+    std::chrono::duration<double, std::milli> took(std::chrono::steady_clock::now() - start);
+    return took.count();
+  }
+
+  // Adds the time and allocations until `stop` or its
+  // destruction to the phase. Only nodes created on the
+  // current thread are counted (see `SharedObj::allocations`).
+  class Phase_Timer {
+    private:
+      Profile* profile;
+      Sass_Compiler_Phase phase;
+      size_t allocations;
+      std::chrono::steady_clock::time_point start;
+    public:
+      Phase_Timer(Profile& profile, Sass_Compiler_Phase phase)
+      : profile(&profile), phase(phase),
+        allocations(SharedObj::allocations),
+        start(std::chrono::steady_clock::now())
+      { }
+      ~Phase_Timer() { stop(); }
+      void stop() {
+        if (profile == 0) return;
+        profile->time[phase] += elapsed_ms(start);
+        profile->allocations[phase] += SharedObj::allocations - allocations;
+        profile = 0;
+      }
+  };
+
+  // Counts a callback and adds its runtime
+  class Callback_Timer {
+    private:
+      Profile::Callbacks& stats;
+      std::chrono::steady_clock::time_point start;
+    public:
+      Callback_Timer(Profile::Callbacks& stats)
+      : stats(stats), start(std::chrono::steady_clock::now())
+      { ++ stats.calls; }
+      ~Callback_Timer() { stats.time += elapsed_ms(start); }
+  };
+
+}
+
+#endif
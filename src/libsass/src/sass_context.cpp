@@ -11,6 +11,10 @@
 #include "json.hpp"
 #include "util.hpp"
 #include "context.hpp"
+#include "sheet_cache.hpp"
+#include "session.hpp"
+#include "file_cache.hpp"
+#include "function_cache.hpp"
 #include "sass_context.hpp"
 #include "sass_functions.hpp"
 #include "ast_fwd_decl.hpp"
@@ -208,6 +212,19 @@ namespace Sass {
     catch (...) { return handle_error(c_ctx); }
   }
 
+  // update the import graph of the session for an entry file
+  // the graph is only a hint, so errors are silently ignored
+  static void sass_record_session(Sass_Context* c_ctx, Context* cpp_ctx, bool failed) throw()
+  {
+    if (c_ctx->session == 0 || c_ctx->type != SASS_CONTEXT_FILE) return;
+    try {
+      std::string entry(cpp_ctx->entry_path);
+      if (entry.empty()) entry = safe_str(c_ctx->input_path);
+      c_ctx->session->record(*cpp_ctx, File::rel2abs(entry, ".", cpp_ctx->CWD), failed);
+    }
+    catch (...) { }
+  }
+
   static Block_Obj sass_parse_block(Sass_Compiler* compiler) throw()
   {
 
@@ -232,6 +249,7 @@ namespace Sass {
 
       // dispatch parse call
       Block_Obj root(cpp_ctx->parse());
+      c_ctx->profile = cpp_ctx->profile;
       // abort on errors
       if (!root) return 0;
 
@@ -245,12 +263,21 @@ namespace Sass {
       if (copy_strings(cpp_ctx->get_included_files(skip, headers), &c_ctx->included_files) == NULL)
         throw(std::bad_alloc());
 
+      // update the import graph
+      sass_record_session(c_ctx, cpp_ctx, false);
+
       // return parsed block
       return root;
 
     }
     // pass errors to generic error handler
-    catch (...) { handle_errors(c_ctx); }
+    catch (...) {
+      // report the phases up to the error
+      c_ctx->profile = cpp_ctx->profile;
+      // graph may be incomplete
+      sass_record_session(c_ctx, cpp_ctx, true);
+      handle_errors(c_ctx);
+    }
 
     // error
     return 0;
@@ -479,6 +506,8 @@ extern "C" {
     if (compiler->cpp_ctx == NULL) return 1;
     if (compiler->c_ctx->error_status)
       return compiler->c_ctx->error_status;
+    // values of custom functions are recycled by the compile
+    Value_Pool::Scope pool(compiler->cpp_ctx->value_pool);
     // parse the context we have set up (file or data)
     compiler->root = sass_parse_block(compiler);
     // success
@@ -498,12 +527,18 @@ extern "C" {
     compiler->state = SASS_COMPILER_EXECUTED;
     Context* cpp_ctx = compiler->cpp_ctx;
     Block_Obj root = compiler->root;
+    Value_Pool::Scope pool(cpp_ctx->value_pool);
     // compile the parsed root block
     try { compiler->c_ctx->output_string = cpp_ctx->render(root); }
     // pass catched errors to generic error handler
-    catch (...) { return handle_errors(compiler->c_ctx) | 1; }
+    catch (...) {
+      compiler->c_ctx->profile = cpp_ctx->profile;
+      return handle_errors(compiler->c_ctx) | 1;
+    }
     // generate source map json and store on context
     compiler->c_ctx->source_map_string = cpp_ctx->render_srcmap();
+    // add the output phases to the profile
+    compiler->c_ctx->profile = cpp_ctx->profile;
     // success
     return 0;
   }
@@ -524,6 +559,10 @@ extern "C" {
     options->c_headers = 0;
     options->plugin_paths = 0;
     options->include_paths = 0;
+    options->sheet_cache = 0;
+    options->session = 0;
+    options->file_cache = 0;
+    options->function_cache = 0;
   }
 
   // helper function, not exported, only accessible locally
@@ -534,6 +573,11 @@ extern "C" {
     sass_delete_function_list(options->c_functions);
     sass_delete_importer_list(options->c_importers);
     sass_delete_importer_list(options->c_headers);
+    // Release our reference to the sheet cache
+    sass_delete_sheet_cache(options->sheet_cache);
+    sass_delete_session(options->session);
+    sass_delete_file_cache(options->file_cache);
+    sass_delete_function_cache(options->function_cache);
     // Deallocate inc paths
     if (options->plugin_paths) {
       struct string_list* cur;
@@ -577,6 +621,10 @@ extern "C" {
     options->c_headers = 0;
     options->plugin_paths = 0;
     options->include_paths = 0;
+    options->sheet_cache = 0;
+    options->session = 0;
+    options->file_cache = 0;
+    options->function_cache = 0;
   }
 
   // helper function, not exported, only accessible locally
@@ -613,11 +661,13 @@ extern "C" {
     if (compiler == 0) {
       return;
     }
+    // release the tree before the context, since
+    // it may hold nodes from leased cached sheets
+    compiler->root = NULL;
     Context* cpp_ctx = compiler->cpp_ctx;
     if (cpp_ctx) delete(cpp_ctx);
     compiler->cpp_ctx = NULL;
     compiler->c_ctx = NULL;
-    compiler->root = NULL;
     free(compiler);
   }
 
@@ -666,10 +716,44 @@ extern "C" {
   Sass_Callee_Entry ADDCALL sass_compiler_get_last_callee(struct Sass_Compiler* compiler) { return &compiler->cpp_ctx->callee_stack.back(); }
   Sass_Callee_Entry ADDCALL sass_compiler_get_callee_entry(struct Sass_Compiler* compiler, size_t idx) { return &compiler->cpp_ctx->callee_stack[idx]; }
 
+  void ADDCALL sass_compiler_cancel(struct Sass_Compiler* compiler)
+  {
+    if (compiler && compiler->cpp_ctx) compiler->cpp_ctx->budget.cancel();
+  }
+
   // Calculate the size of the stored null terminated array
   size_t ADDCALL sass_context_get_included_files_size (struct Sass_Context* ctx)
   { size_t l = 0; auto i = ctx->included_files; while (i && *i) { ++i; ++l; } return l; }
 
+  const char* ADDCALL sass_compiler_phase_name (enum Sass_Compiler_Phase phase)
+  {
+    switch (phase) {
+      case SASS_PHASE_PARSE: return "parse";
+      case SASS_PHASE_EXPAND: return "expand";
+      case SASS_PHASE_CHECK_NESTING: return "check_nesting";
+      case SASS_PHASE_CSSIZE: return "cssize";
+      case SASS_PHASE_EXTEND: return "extend";
+      case SASS_PHASE_REMOVE_PLACEHOLDERS: return "remove_placeholders";
+      case SASS_PHASE_OUTPUT: return "output";
+      case SASS_PHASE_SOURCE_MAP: return "source_map";
+    }
+    return 0;
+  }
+
+  // Profiling of the last compilation
+  double ADDCALL sass_context_get_phase_time (struct Sass_Context* ctx, enum Sass_Compiler_Phase phase)
+  { return phase < PHASE_COUNT ? ctx->profile.time[phase] : 0; }
+  size_t ADDCALL sass_context_get_phase_allocations (struct Sass_Context* ctx, enum Sass_Compiler_Phase phase)
+  { return phase < PHASE_COUNT ? ctx->profile.allocations[phase] : 0; }
+  size_t ADDCALL sass_context_get_function_calls (struct Sass_Context* ctx) { return ctx->profile.functions.calls; }
+  double ADDCALL sass_context_get_function_time (struct Sass_Context* ctx) { return ctx->profile.functions.time; }
+  size_t ADDCALL sass_context_get_importer_calls (struct Sass_Context* ctx) { return ctx->profile.importers.calls; }
+  double ADDCALL sass_context_get_importer_time (struct Sass_Context* ctx) { return ctx->profile.importers.time; }
+  size_t ADDCALL sass_context_get_lookahead_probes (struct Sass_Context* ctx) { return ctx->profile.lookaheads.probes; }
+  size_t ADDCALL sass_context_get_lookahead_hits (struct Sass_Context* ctx) { return ctx->profile.lookaheads.hits; }
+  size_t ADDCALL sass_context_get_lookahead_scanned (struct Sass_Context* ctx) { return ctx->profile.lookaheads.scanned; }
+  size_t ADDCALL sass_context_get_lookahead_saved (struct Sass_Context* ctx) { return ctx->profile.lookaheads.saved; }
+
   // Create getter and setters for options
   IMPLEMENT_SASS_OPTION_ACCESSOR(int, precision);
   IMPLEMENT_SASS_OPTION_ACCESSOR(enum Sass_Output_Style, output_style);
@@ -679,6 +763,10 @@ extern "C" {
   IMPLEMENT_SASS_OPTION_ACCESSOR(bool, source_map_file_urls);
   IMPLEMENT_SASS_OPTION_ACCESSOR(bool, omit_source_map_url);
   IMPLEMENT_SASS_OPTION_ACCESSOR(bool, is_indented_syntax_src);
+  IMPLEMENT_SASS_OPTION_ACCESSOR(int, import_threads);
+  IMPLEMENT_SASS_OPTION_ACCESSOR(bool, mmap_sources);
+  IMPLEMENT_SASS_OPTION_ACCESSOR(size_t, timeout);
+  IMPLEMENT_SASS_OPTION_ACCESSOR(size_t, max_steps);
   IMPLEMENT_SASS_OPTION_ACCESSOR(Sass_Function_List, c_functions);
   IMPLEMENT_SASS_OPTION_ACCESSOR(Sass_Importer_List, c_importers);
   IMPLEMENT_SASS_OPTION_ACCESSOR(Sass_Importer_List, c_headers);
@@ -713,6 +801,212 @@ extern "C" {
   IMPLEMENT_SASS_CONTEXT_TAKER(char*, source_map_string);
   IMPLEMENT_SASS_CONTEXT_TAKER(char**, included_files);
 
+  // Options hold their own reference to the sheet cache
+  void ADDCALL sass_option_set_sheet_cache(struct Sass_Options* options, struct Sass_Sheet_Cache* sheet_cache)
+  {
+    if (sheet_cache) sass_sheet_cache_retain(sheet_cache);
+    sass_delete_sheet_cache(options->sheet_cache);
+    options->sheet_cache = sheet_cache;
+  }
+
+  struct Sass_Sheet_Cache* ADDCALL sass_option_get_sheet_cache(struct Sass_Options* options)
+  {
+    return options->sheet_cache;
+  }
+
+  struct Sass_Sheet_Cache* ADDCALL sass_make_sheet_cache(void)
+  {
+    return new Sass_Sheet_Cache();
+  }
+
+  struct Sass_Sheet_Cache* ADDCALL sass_sheet_cache_retain(struct Sass_Sheet_Cache* cache)
+  {
+    if (cache) cache->retain();
+    return cache;
+  }
+
+  void ADDCALL sass_delete_sheet_cache(struct Sass_Sheet_Cache* cache)
+  {
+    if (cache && cache->release()) delete cache;
+  }
+
+  void ADDCALL sass_sheet_cache_invalidate(struct Sass_Sheet_Cache* cache, const char* abs_path)
+  {
+    if (cache && abs_path) cache->invalidate(File::rel2abs(abs_path));
+  }
+
+  void ADDCALL sass_sheet_cache_clear(struct Sass_Sheet_Cache* cache)
+  {
+    if (cache) cache->clear();
+  }
+
+  size_t ADDCALL sass_sheet_cache_get_size(struct Sass_Sheet_Cache* cache) { return cache ? cache->size() : 0; }
+  size_t ADDCALL sass_sheet_cache_get_hits(struct Sass_Sheet_Cache* cache) { return cache ? cache->get_hits() : 0; }
+  size_t ADDCALL sass_sheet_cache_get_misses(struct Sass_Sheet_Cache* cache) { return cache ? cache->get_misses() : 0; }
+
+  // Options hold their own reference to the file cache
+  void ADDCALL sass_option_set_file_cache(struct Sass_Options* options, struct Sass_File_Cache* file_cache)
+  {
+    if (file_cache) sass_file_cache_retain(file_cache);
+    sass_delete_file_cache(options->file_cache);
+    options->file_cache = file_cache;
+  }
+
+  struct Sass_File_Cache* ADDCALL sass_option_get_file_cache(struct Sass_Options* options)
+  {
+    return options->file_cache;
+  }
+
+  struct Sass_File_Cache* ADDCALL sass_make_file_cache(void)
+  {
+    return new Sass_File_Cache();
+  }
+
+  struct Sass_File_Cache* ADDCALL sass_file_cache_retain(struct Sass_File_Cache* cache)
+  {
+    if (cache) cache->retain();
+    return cache;
+  }
+
+  void ADDCALL sass_delete_file_cache(struct Sass_File_Cache* cache)
+  {
+    if (cache && cache->release()) delete cache;
+  }
+
+  void ADDCALL sass_file_cache_invalidate(struct Sass_File_Cache* cache, const char* abs_path)
+  {
+    if (cache && abs_path) cache->invalidate(File::rel2abs(abs_path));
+  }
+
+  void ADDCALL sass_file_cache_clear(struct Sass_File_Cache* cache)
+  {
+    if (cache) cache->clear();
+  }
+
+  size_t ADDCALL sass_file_cache_get_size(struct Sass_File_Cache* cache) { return cache ? cache->size() : 0; }
+  size_t ADDCALL sass_file_cache_get_hits(struct Sass_File_Cache* cache) { return cache ? cache->get_hits() : 0; }
+  size_t ADDCALL sass_file_cache_get_misses(struct Sass_File_Cache* cache) { return cache ? cache->get_misses() : 0; }
+
+  // Options hold their own reference to the function cache
+  void ADDCALL sass_option_set_function_cache(struct Sass_Options* options, struct Sass_Function_Cache* function_cache)
+  {
+    if (function_cache) sass_function_cache_retain(function_cache);
+    sass_delete_function_cache(options->function_cache);
+    options->function_cache = function_cache;
+  }
+
+  struct Sass_Function_Cache* ADDCALL sass_option_get_function_cache(struct Sass_Options* options)
+  {
+    return options->function_cache;
+  }
+
+  // The sink is called on the compiling thread
+  void ADDCALL sass_option_set_output_sink(struct Sass_Options* options, Sass_Output_Sink output_sink, void* cookie)
+  {
+    options->output_sink = output_sink;
+    options->output_sink_cookie = cookie;
+  }
+
+  Sass_Output_Sink ADDCALL sass_option_get_output_sink(struct Sass_Options* options)
+  {
+    return options->output_sink;
+  }
+
+  struct Sass_Function_Cache* ADDCALL sass_make_function_cache(void)
+  {
+    return new Sass_Function_Cache();
+  }
+
+  struct Sass_Function_Cache* ADDCALL sass_function_cache_retain(struct Sass_Function_Cache* cache)
+  {
+    if (cache) cache->retain();
+    return cache;
+  }
+
+  void ADDCALL sass_delete_function_cache(struct Sass_Function_Cache* cache)
+  {
+    if (cache && cache->release()) delete cache;
+  }
+
+  void ADDCALL sass_function_cache_clear(struct Sass_Function_Cache* cache)
+  {
+    if (cache) cache->clear();
+  }
+
+  size_t ADDCALL sass_function_cache_get_size(struct Sass_Function_Cache* cache) { return cache ? cache->size() : 0; }
+  size_t ADDCALL sass_function_cache_get_hits(struct Sass_Function_Cache* cache) { return cache ? cache->get_hits() : 0; }
+  size_t ADDCALL sass_function_cache_get_misses(struct Sass_Function_Cache* cache) { return cache ? cache->get_misses() : 0; }
+
+  // Options hold their own reference to the session
+  void ADDCALL sass_option_set_session(struct Sass_Options* options, struct Sass_Session* session)
+  {
+    if (session) sass_session_retain(session);
+    sass_delete_session(options->session);
+    options->session = session;
+  }
+
+  struct Sass_Session* ADDCALL sass_option_get_session(struct Sass_Options* options)
+  {
+    return options->session;
+  }
+
+  struct Sass_Session* ADDCALL sass_make_session(void)
+  {
+    return new Sass_Session();
+  }
+
+  struct Sass_Session* ADDCALL sass_session_retain(struct Sass_Session* session)
+  {
+    if (session) session->retain();
+    return session;
+  }
+
+  void ADDCALL sass_delete_session(struct Sass_Session* session)
+  {
+    if (session && session->release()) delete session;
+  }
+
+  struct Sass_Sheet_Cache* ADDCALL sass_session_get_sheet_cache(struct Sass_Session* session)
+  {
+    return static_cast<struct Sass_Sheet_Cache*>(session->sheet_cache());
+  }
+
+  struct Sass_File_Cache* ADDCALL sass_session_get_file_cache(struct Sass_Session* session)
+  {
+    return static_cast<struct Sass_File_Cache*>(session->file_cache());
+  }
+
+  char** ADDCALL sass_session_file_changed(struct Sass_Session* session, const char* abs_path)
+  {
+    char** list = 0;
+    copy_strings(session->changed(File::rel2abs(abs_path)), &list);
+    return list;
+  }
+
+  char** ADDCALL sass_session_get_dependencies(struct Sass_Session* session, const char* abs_path)
+  {
+    char** list = 0;
+    copy_strings(session->dependencies(File::rel2abs(abs_path)), &list);
+    return list;
+  }
+
+  char** ADDCALL sass_session_get_entries(struct Sass_Session* session)
+  {
+    char** list = 0;
+    copy_strings(session->get_entries(), &list);
+    return list;
+  }
+
+  void ADDCALL sass_session_forget_entry(struct Sass_Session* session, const char* abs_path)
+  {
+    session->forget(File::rel2abs(abs_path));
+  }
+
+  void ADDCALL sass_delete_string_list(char** list)
+  {
+    free_string_array(list);
+  }
+
   // Push function for include paths (no manipulation support for now)
   void ADDCALL sass_option_push_include_path(struct Sass_Options* options, const char* path)
   {
@@ -4,6 +4,7 @@
 #include "sass/base.h"
 #include "sass/context.h"
 #include "ast_fwd_decl.hpp"
+#include "profiler.hpp"
 
 // sass config options structure
 struct Sass_Options : Sass_Output_Options {
@@ -23,6 +24,19 @@ struct Sass_Options : Sass_Output_Options {
   // Treat source_string as sass (as opposed to scss)
   bool is_indented_syntax_src;
 
+  // Parse imports on this many worker
+  // threads ahead of the compilation
+  int import_threads;
+
+  // Memory map big source files instead
+  // of copying them into the heap
+  bool mmap_sources;
+
+  // Stop the compilation after this many
+  // milliseconds or loop iterations
+  size_t timeout;
+  size_t max_steps;
+
   // The input path is used for source map
   // generation. It can be used to define
   // something with string compilation or to
@@ -65,6 +79,22 @@ struct Sass_Options : Sass_Output_Options {
   // List of custom headers
   Sass_Importer_List c_headers;
 
+  // Shared cache for parsed stylesheets
+  struct Sass_Sheet_Cache* sheet_cache;
+
+  // Session recording the import graph
+  struct Sass_Session* session;
+
+  // Shared cache for directory listings
+  struct Sass_File_Cache* file_cache;
+
+  // Shared cache for pure function results
+  struct Sass_Function_Cache* function_cache;
+
+  // Receives the css output in chunks
+  Sass_Output_Sink output_sink;
+  void* output_sink_cookie;
+
 };
 
 
@@ -95,6 +125,9 @@ struct Sass_Context : Sass_Options
   // report imported files
   char** included_files;
 
+  // phase times and callback counts
+  Sass::Profile profile;
+
 };
 
 // struct for file compilation
@@ -10,6 +10,7 @@ struct Sass_Function {
   char*            signature;
   Sass_Function_Fn function;
   void*            cookie;
+  bool             pure;
 };
 
 // External import entry
@@ -7,6 +7,22 @@
 #include "operators.hpp"
 #include "sass/values.h"
 #include "sass_values.hpp"
+#include "value_pool.hpp"
+
+namespace Sass {
+
+  union Sass_Value* make_borrowed_string(const char* val, bool quoted)
+  {
+    union Sass_Value* v = (Sass_Value*) Value_Pool::allocate(sizeof(Sass_Value));
+    if (v == 0) return 0;
+    v->string.tag = SASS_STRING;
+    v->string.quoted = quoted;
+    v->string.borrowed = true;
+    v->string.value = const_cast<char*>(val);
+    return v;
+  }
+
+}
 
 extern "C" {
   using namespace Sass;
@@ -33,7 +49,7 @@ extern "C" {
 
   // Getters and setters for Sass_String
   const char* ADDCALL sass_string_get_value(const union Sass_Value* v) { return v->string.value; }
-  void ADDCALL sass_string_set_value(union Sass_Value* v, char* value) { v->string.value = value; }
+  void ADDCALL sass_string_set_value(union Sass_Value* v, char* value) { v->string.value = value; v->string.borrowed = false; }
   bool ADDCALL sass_string_is_quoted(const union Sass_Value* v) { return v->string.quoted; }
   void ADDCALL sass_string_set_quoted(union Sass_Value* v, bool quoted) { v->string.quoted = quoted; }
 
@@ -81,7 +97,7 @@ extern "C" {
 
   union Sass_Value* ADDCALL sass_make_boolean(bool val)
   {
-    union Sass_Value* v = (Sass_Value*) calloc(1, sizeof(Sass_Value));
+    union Sass_Value* v = (Sass_Value*) Value_Pool::allocate(sizeof(Sass_Value));
     if (v == 0) return 0;
     v->boolean.tag = SASS_BOOLEAN;
     v->boolean.value = val;
@@ -90,18 +106,18 @@ extern "C" {
 
   union Sass_Value* ADDCALL sass_make_number(double val, const char* unit)
   {
-    union Sass_Value* v = (Sass_Value*) calloc(1, sizeof(Sass_Value));
+    union Sass_Value* v = (Sass_Value*) Value_Pool::allocate(sizeof(Sass_Value));
     if (v == 0) return 0;
     v->number.tag = SASS_NUMBER;
     v->number.value = val;
     v->number.unit = unit ? sass_copy_c_string(unit) : 0;
-    if (v->number.unit == 0) { free(v); return 0; }
+    if (v->number.unit == 0) { Value_Pool::release(v, sizeof(Sass_Value)); return 0; }
     return v;
   }
 
   union Sass_Value* ADDCALL sass_make_color(double r, double g, double b, double a)
   {
-    union Sass_Value* v = (Sass_Value*) calloc(1, sizeof(Sass_Value));
+    union Sass_Value* v = (Sass_Value*) Value_Pool::allocate(sizeof(Sass_Value));
     if (v == 0) return 0;
     v->color.tag = SASS_COLOR;
     v->color.r = r;
@@ -113,53 +129,53 @@ extern "C" {
 
   union Sass_Value* ADDCALL sass_make_string(const char* val)
   {
-    union Sass_Value* v = (Sass_Value*) calloc(1, sizeof(Sass_Value));
+    union Sass_Value* v = (Sass_Value*) Value_Pool::allocate(sizeof(Sass_Value));
     if (v == 0) return 0;
     v->string.quoted = false;
     v->string.tag = SASS_STRING;
     v->string.value = val ? sass_copy_c_string(val) : 0;
-    if (v->string.value == 0) { free(v); return 0; }
+    if (v->string.value == 0) { Value_Pool::release(v, sizeof(Sass_Value)); return 0; }
     return v;
   }
 
   union Sass_Value* ADDCALL sass_make_qstring(const char* val)
   {
-    union Sass_Value* v = (Sass_Value*) calloc(1, sizeof(Sass_Value));
+    union Sass_Value* v = (Sass_Value*) Value_Pool::allocate(sizeof(Sass_Value));
     if (v == 0) return 0;
     v->string.quoted = true;
     v->string.tag = SASS_STRING;
     v->string.value = val ? sass_copy_c_string(val) : 0;
-    if (v->string.value == 0) { free(v); return 0; }
+    if (v->string.value == 0) { Value_Pool::release(v, sizeof(Sass_Value)); return 0; }
     return v;
   }
 
   union Sass_Value* ADDCALL sass_make_list(size_t len, enum Sass_Separator sep, bool is_bracketed)
   {
-    union Sass_Value* v = (Sass_Value*) calloc(1, sizeof(Sass_Value));
+    union Sass_Value* v = (Sass_Value*) Value_Pool::allocate(sizeof(Sass_Value));
     if (v == 0) return 0;
     v->list.tag = SASS_LIST;
     v->list.length = len;
     v->list.separator = sep;
     v->list.is_bracketed = is_bracketed;
-    v->list.values = (union Sass_Value**) calloc(len, sizeof(union Sass_Value*));
-    if (v->list.values == 0) { free(v); return 0; }
+    v->list.values = (union Sass_Value**) Value_Pool::allocate(len * sizeof(union Sass_Value*));
+    if (v->list.values == 0) { Value_Pool::release(v, sizeof(Sass_Value)); return 0; }
     return v;
   }
 
   union Sass_Value* ADDCALL sass_make_map(size_t len)
   {
-    union Sass_Value* v = (Sass_Value*) calloc(1, sizeof(Sass_Value));
+    union Sass_Value* v = (Sass_Value*) Value_Pool::allocate(sizeof(Sass_Value));
     if (v == 0) return 0;
     v->map.tag = SASS_MAP;
     v->map.length = len;
-    v->map.pairs = (struct Sass_MapPair*) calloc(len, sizeof(struct Sass_MapPair));
-    if (v->map.pairs == 0) { free(v); return 0; }
+    v->map.pairs = (struct Sass_MapPair*) Value_Pool::allocate(len * sizeof(struct Sass_MapPair));
+    if (v->map.pairs == 0) { Value_Pool::release(v, sizeof(Sass_Value)); return 0; }
     return v;
   }
 
   union Sass_Value* ADDCALL sass_make_null(void)
   {
-    union Sass_Value* v = (Sass_Value*) calloc(1, sizeof(Sass_Value));
+    union Sass_Value* v = (Sass_Value*) Value_Pool::allocate(sizeof(Sass_Value));
     if (v == 0) return 0;
     v->null.tag = SASS_NULL;
     return v;
@@ -167,21 +183,21 @@ extern "C" {
 
   union Sass_Value* ADDCALL sass_make_error(const char* msg)
   {
-    union Sass_Value* v = (Sass_Value*) calloc(1, sizeof(Sass_Value));
+    union Sass_Value* v = (Sass_Value*) Value_Pool::allocate(sizeof(Sass_Value));
     if (v == 0) return 0;
     v->error.tag = SASS_ERROR;
     v->error.message = msg ? sass_copy_c_string(msg) : 0;
-    if (v->error.message == 0) { free(v); return 0; }
+    if (v->error.message == 0) { Value_Pool::release(v, sizeof(Sass_Value)); return 0; }
     return v;
   }
 
   union Sass_Value* ADDCALL sass_make_warning(const char* msg)
   {
-    union Sass_Value* v = (Sass_Value*) calloc(1, sizeof(Sass_Value));
+    union Sass_Value* v = (Sass_Value*) Value_Pool::allocate(sizeof(Sass_Value));
     if (v == 0) return 0;
     v->warning.tag = SASS_WARNING;
     v->warning.message = msg ? sass_copy_c_string(msg) : 0;
-    if (v->warning.message == 0) { free(v); return 0; }
+    if (v->warning.message == 0) { Value_Pool::release(v, sizeof(Sass_Value)); return 0; }
     return v;
   }
 
@@ -201,20 +217,20 @@ extern "C" {
         case SASS_COLOR: {
         }   break;
         case SASS_STRING: {
-                free(val->string.value);
+                if (!val->string.borrowed) free(val->string.value);
         }   break;
         case SASS_LIST: {
                 for (i=0; i<val->list.length; i++) {
                     sass_delete_value(val->list.values[i]);
                 }
-                free(val->list.values);
+                Value_Pool::release(val->list.values, val->list.length * sizeof(union Sass_Value*));
         }   break;
         case SASS_MAP: {
                 for (i=0; i<val->map.length; i++) {
                     sass_delete_value(val->map.pairs[i].key);
                     sass_delete_value(val->map.pairs[i].value);
                 }
-                free(val->map.pairs);
+                Value_Pool::release(val->map.pairs, val->map.length * sizeof(struct Sass_MapPair));
         }   break;
         case SASS_ERROR: {
                 free(val->error.message);
@@ -225,7 +241,7 @@ extern "C" {
         default: break;
     }
 
-    free(val);
+    Value_Pool::release(val, sizeof(Sass_Value));
 
     }
 
@@ -29,6 +29,8 @@ struct Sass_Color {
 struct Sass_String {
   enum Sass_Tag tag;
   bool          quoted;
+  // value is owned by someone else
+  bool          borrowed;
   char*         value;
 };
 
@@ -79,4 +81,13 @@ struct Sass_MapPair {
   union Sass_Value* value;
 };
 
+namespace Sass {
+
+  // String pointing to the given text instead of a copy
+  // (the text must outlive the value, which must not be
+  // handed out of the call it was made for)
+  union Sass_Value* make_borrowed_string(const char* val, bool quoted);
+
+}
+
 #endif
@@ -0,0 +1,134 @@
+#include "sass.hpp"
+#include <deque>
+
+#include "ast.hpp"
+#include "context.hpp"
+#include "session.hpp"
+
+namespace Sass {
+
+  // name a file can be imported by (no underscore or extension)
+  static std::string import_stem(const std::string& path)
+  {
+    std::string stem(File::base_name(path));
+    if (!stem.empty() && stem[0] == '_') stem.erase(0, 1);
+    size_t dot = stem.find_last_of('.');
+    if (dot != std::string::npos) {
+      std::string ext(stem.substr(dot));
+      if (ext == ".scss" || ext == ".sass" || ext == ".css") stem.erase(dot);
+    }
+    return stem;
+  }
+
+  Session::Session()
+  : mutex(), cache(new Sheet_Cache()), files(new File_Cache()), refcount(1),
+    entries(), requests(), imports(), failed()
+  { }
+
+  Session::~Session()
+  {
+    if (cache->release()) delete cache;
+    if (files->release()) delete files;
+  }
+
+  Session* Session::retain()
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    ++ refcount;
+    return this;
+  }
+
+  // returns true if the last reference was dropped
+  // caller is then responsible to delete the object
+  bool Session::release()
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    return -- refcount == 0;
+  }
+
+  void Session::record(Context& ctx, const std::string& entry, bool incomplete)
+  {
+    // collect the direct imports of every loaded file
+    std::map<std::string, std::set<std::string>> edges;
+    std::set<std::string> files;
+    std::set<std::string> stems;
+    for (const std::string& file : ctx.included_files) {
+      std::string abs_path(File::rel2abs(file, ".", ctx.CWD));
+      edges[abs_path]; files.insert(abs_path);
+    }
+    for (auto& edge : ctx.import_edges) {
+      std::string from(File::rel2abs(edge.first.ctx_path, ".", ctx.CWD));
+      edges[from].insert(File::rel2abs(edge.second.abs_path, ".", ctx.CWD));
+      stems.insert(import_stem(edge.first.imp_path));
+    }
+    files.insert(entry);
+
+    std::lock_guard<std::mutex> lock(mutex);
+    // files seen by a successful parse are complete, their
+    // direct imports replace the old ones (otherwise merge)
+    for (auto& edge : edges) {
+      if (incomplete) imports[edge.first].insert(edge.second.begin(), edge.second.end());
+      else imports[edge.first] = edge.second;
+    }
+    entries[entry] = files;
+    requests[entry] = stems;
+    if (incomplete) failed.insert(entry);
+    else failed.erase(entry);
+  }
+
+  std::vector<std::string> Session::changed(const std::string& abs_path)
+  {
+    std::set<std::string> affected;
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      std::string stem(import_stem(abs_path));
+      for (auto& entry : entries) {
+        // entry depends on the file
+        if (entry.second.count(abs_path)) affected.insert(entry.first);
+      }
+      for (auto& entry : requests) {
+        // new file may shadow the one used before
+        if (entry.second.count(stem)) affected.insert(entry.first);
+      }
+      // any file may fix a missing import
+      affected.insert(failed.begin(), failed.end());
+    }
+    cache->invalidate(abs_path);
+    files->invalidate(abs_path);
+    return std::vector<std::string>(affected.begin(), affected.end());
+  }
+
+  std::vector<std::string> Session::dependencies(const std::string& abs_path)
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    std::set<std::string> seen;
+    std::deque<std::string> queue(1, abs_path);
+    while (!queue.empty()) {
+      auto it = imports.find(queue.front());
+      queue.pop_front();
+      if (it == imports.end()) continue;
+      for (const std::string& file : it->second) {
+        if (seen.insert(file).second) queue.push_back(file);
+      }
+    }
+    seen.erase(abs_path);
+    return std::vector<std::string>(seen.begin(), seen.end());
+  }
+
+  std::vector<std::string> Session::get_entries()
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    std::vector<std::string> rv;
+    for (auto& entry : entries) rv.push_back(entry.first);
+    return rv;
+  }
+
+  void Session::forget(const std::string& entry)
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    entries.erase(entry);
+    requests.erase(entry);
+    failed.erase(entry);
+  }
+
+}
@@ -0,0 +1,63 @@
+#ifndef SASS_SESSION_H
+#define SASS_SESSION_H
+
+#include <map>
+#include <set>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "sheet_cache.hpp"
+#include "file_cache.hpp"
+
+namespace Sass {
+
+  class Context;
+
+  // Long lived state for incremental recompilation.
+  // Records the import graph of every entry file that is
+  // compiled with the session and owns a sheet cache, so
+  // unchanged files are not parsed again on recompilation.
+  class Session {
+    private:
+      std::mutex mutex;
+      Sheet_Cache* cache;
+      File_Cache* files;
+      size_t refcount;
+      // entry file -> all files it includes (itself too)
+      std::map<std::string, std::set<std::string>> entries;
+      // entry file -> basenames of all requested imports
+      std::map<std::string, std::set<std::string>> requests;
+      // file -> files it imports directly
+      std::map<std::string, std::set<std::string>> imports;
+      // entries whose import graph is incomplete
+      std::set<std::string> failed;
+    public:
+      Session();
+      virtual ~Session();
+      // reference counting for shared ownership
+      Session* retain();
+      bool release();
+      // the cache shared by all contexts of the session
+      Sheet_Cache* sheet_cache() { return cache; }
+      // directory listings, only used if also set as option
+      File_Cache* file_cache() { return files; }
+      // update the graph after the entry has been parsed
+      void record(Context& ctx, const std::string& entry, bool failed);
+      // invalidate a changed, added or removed file and
+      // return all entries that need to be recompiled
+      std::vector<std::string> changed(const std::string& abs_path);
+      // all files imported by the given file (recursively)
+      std::vector<std::string> dependencies(const std::string& abs_path);
+      // all recorded entry files
+      std::vector<std::string> get_entries();
+      // drop the graph of an entry file
+      void forget(const std::string& entry);
+  };
+
+}
+
+// C-API handle for the compiler session
+struct Sass_Session : Sass::Session { };
+
+#endif
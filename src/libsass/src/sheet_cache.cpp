@@ -0,0 +1,198 @@
+#include "sass.hpp"
+#include <cstdlib>
+#include <cstring>
+#include <algorithm>
+
+#include "ast.hpp"
+#include "sheet_cache.hpp"
+
+namespace Sass {
+
+  // FNV-1a over the (converted) file contents
+  static size_t hash_contents(const char* contents)
+  {
+    size_t hash = static_cast<size_t>(14695981039346656037ULL);
+    while (contents && *contents) {
+      hash ^= static_cast<unsigned char>(*contents++);
+      hash *= static_cast<size_t>(1099511628211ULL);
+    }
+    return hash;
+  }
+
+  Cached_Sheet::Cached_Sheet(const std::string& abs_path, const std::string& load_path, const std::string& env_key, char* contents)
+  : abs_path(abs_path),
+    env_key(env_key),
+    mtime(0),
+    size(0),
+    hash(hash_contents(contents)),
+    path(sass_copy_c_string(load_path.c_str())),
+    contents(contents),
+    root(),
+    imports(),
+    leased(true),
+    stale(false)
+  {
+    // remember the signature of the file on disk
+    if (!File::file_stats(abs_path, mtime, size)) stale = true;
+  }
+
+  Cached_Sheet::~Cached_Sheet()
+  {
+    // release nodes before the buffers
+    // they point into are deallocated
+    imports.clear();
+    root = {};
+    File::free_file(contents);
+    free(path);
+  }
+
+  Sheet_Cache::Sheet_Cache()
+  : mutex(), sheets(), refcount(1), hits(0), misses(0)
+  { }
+
+  Sheet_Cache::~Sheet_Cache()
+  {
+    clear();
+  }
+
+  Sheet_Cache* Sheet_Cache::retain()
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    ++ refcount;
+    return this;
+  }
+
+  // returns true if the last reference was dropped
+  // caller is then responsible to delete the object
+  bool Sheet_Cache::release()
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    return -- refcount == 0;
+  }
+
+  // check sheet against the file on disk
+  // only called by the owner of the lease
+  bool Sheet_Cache::validate(Cached_Sheet* sheet)
+  {
+    long long mtime; size_t size;
+    if (!File::file_stats(sheet->abs_path, mtime, size)) return false;
+    if (mtime == sheet->mtime && size == sheet->size) return true;
+    // signature changed, but maybe the content did not
+    char* contents = File::read_file(sheet->abs_path);
+    if (contents == 0) return false;
+    size_t hash = hash_contents(contents);
+    File::free_file(contents);
+    if (hash != sheet->hash) return false;
+    // only touched, update signature
+    sheet->mtime = mtime;
+    sheet->size = size;
+    return true;
+  }
+
+  Cached_Sheet* Sheet_Cache::acquire(const std::string& abs_path, const std::string& env_key)
+  {
+    Cached_Sheet* sheet = 0;
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      auto it = sheets.find(abs_path);
+      if (it != sheets.end()) {
+        for (Cached_Sheet* candidate : it->second) {
+          if (candidate->leased || candidate->stale) continue;
+          if (candidate->env_key != env_key) continue;
+          candidate->leased = true;
+          sheet = candidate;
+          break;
+        }
+      }
+      if (sheet == 0) { ++ misses; return 0; }
+    }
+    // do the file system checks outside of the lock
+    if (validate(sheet)) {
+      std::lock_guard<std::mutex> lock(mutex);
+      ++ hits;
+      return sheet;
+    }
+    // outdated, every other copy is outdated too
+    invalidate(abs_path);
+    release(sheet);
+    std::lock_guard<std::mutex> lock(mutex);
+    ++ misses;
+    return 0;
+  }
+
+  Cached_Sheet* Sheet_Cache::create(const std::string& abs_path, const std::string& load_path, const std::string& env_key, char* contents)
+  {
+    Cached_Sheet* sheet = new Cached_Sheet(abs_path, load_path, env_key, contents);
+    std::lock_guard<std::mutex> lock(mutex);
+    sheets[abs_path].push_back(sheet);
+    return sheet;
+  }
+
+  void Sheet_Cache::release(Cached_Sheet* sheet)
+  {
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      sheet->leased = false;
+      // keep complete and valid sheets around
+      if (!sheet->stale && !sheet->root.isNull()) return;
+      auto it = sheets.find(sheet->abs_path);
+      if (it != sheets.end()) {
+        auto& pool = it->second;
+        pool.erase(std::remove(pool.begin(), pool.end(), sheet), pool.end());
+        if (pool.empty()) sheets.erase(it);
+      }
+    }
+    delete sheet;
+  }
+
+  void Sheet_Cache::invalidate(const std::string& abs_path)
+  {
+    std::vector<Cached_Sheet*> unused;
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      auto it = sheets.find(abs_path);
+      if (it == sheets.end()) return;
+      std::vector<Cached_Sheet*> leased;
+      for (Cached_Sheet* sheet : it->second) {
+        // leased sheets are dropped on release
+        sheet->stale = true;
+        if (sheet->leased) leased.push_back(sheet);
+        else unused.push_back(sheet);
+      }
+      if (leased.empty()) sheets.erase(it);
+      else it->second = leased;
+    }
+    for (Cached_Sheet* sheet : unused) delete sheet;
+  }
+
+  void Sheet_Cache::clear()
+  {
+    std::vector<std::string> paths;
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      for (auto& pool : sheets) paths.push_back(pool.first);
+    }
+    for (const std::string& abs_path : paths) invalidate(abs_path);
+  }
+
+  size_t Sheet_Cache::size()
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    size_t count = 0;
+    for (auto& pool : sheets) count += pool.second.size();
+    return count;
+  }
+
+  size_t Sheet_Cache::get_hits()
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    return hits;
+  }
+
+  size_t Sheet_Cache::get_misses()
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    return misses;
+  }
+
+}
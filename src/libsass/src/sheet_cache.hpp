@@ -0,0 +1,103 @@
+#ifndef SASS_SHEET_CACHE_H
+#define SASS_SHEET_CACHE_H
+
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "ast_fwd_decl.hpp"
+#include "position.hpp"
+#include "file.hpp"
+
+namespace Sass {
+
+  // import resolved while parsing a cached sheet
+  // replayed on every context that reuses the sheet
+  class Cached_Import {
+    public:
+      // requested import
+      Importer importer;
+      // resolved include (final import)
+      Include include;
+      // position of the `@import` rule
+      ParserState pstate;
+    public:
+      Cached_Import(const Importer& importer, const Include& include, const ParserState& pstate)
+      : importer(importer), include(include), pstate(pstate)
+      { }
+  };
+
+  // parsed stylesheet that outlives its context
+  // the parser states of the tree point into the
+  // buffers owned by this object (path/contents)
+  class Cached_Sheet {
+    public:
+      // absolute path (cache key)
+      std::string abs_path;
+      // settings that affect import resolution
+      std::string env_key;
+      // file signature when it was loaded
+      long long mtime;
+      size_t size;
+      size_t hash;
+      // buffers referenced by parser states
+      // path is the one the sheet was loaded by
+      char* path;
+      char* contents;
+      // parsed root block (null until parsed)
+      Block_Obj root;
+      // includes resolved while parsing
+      std::vector<Cached_Import> imports;
+      // owned by a context right now
+      bool leased;
+      // must not be handed out again
+      bool stale;
+    public:
+      Cached_Sheet(const std::string& abs_path, const std::string& load_path, const std::string& env_key, char* contents);
+      ~Cached_Sheet();
+  };
+
+  // Thread safe store for parsed stylesheets.
+  // A sheet is leased exclusively to one context at a time, since
+  // the reference counters of the AST nodes are not synchronized.
+  // Concurrent compilations that need the same file while it is
+  // leased parse their own copy, which is then added to the pool.
+  class Sheet_Cache {
+    private:
+      std::mutex mutex;
+      std::map<std::string, std::vector<Cached_Sheet*>> sheets;
+      size_t refcount;
+      size_t hits;
+      size_t misses;
+    public:
+      Sheet_Cache();
+      virtual ~Sheet_Cache();
+      // reference counting for shared ownership
+      Sheet_Cache* retain();
+      bool release();
+      // lease a valid sheet or return null
+      Cached_Sheet* acquire(const std::string& abs_path, const std::string& env_key);
+      // create a leased sheet from a freshly read buffer
+      Cached_Sheet* create(const std::string& abs_path, const std::string& load_path, const std::string& env_key, char* contents);
+      // give back a leased sheet (drops incomplete ones)
+      void release(Cached_Sheet* sheet);
+      // drop all sheets for the given path
+      void invalidate(const std::string& abs_path);
+      // drop all sheets
+      void clear();
+      // statistics
+      size_t size();
+      size_t get_hits();
+      size_t get_misses();
+    private:
+      // check sheet against the file on disk
+      bool validate(Cached_Sheet* sheet);
+  };
+
+}
+
+// C-API handle for the parsed stylesheet cache
+struct Sass_Sheet_Cache : Sass::Sheet_Cache { };
+
+#endif
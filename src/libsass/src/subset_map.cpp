@@ -4,43 +4,86 @@
 
 namespace Sass {
 
+  // classes marked by the current query of the thread
+  // (all marks are cleared when the query is done)
+  static thread_local std::vector<uint64_t> marks;
+
   void Subset_Map::put(const Compound_Selector_Obj& sel, const SubSetMapPair& value)
   {
     if (sel->empty()) throw std::runtime_error("internal error: subset map keys may not be empty");
     size_t index = values_.size();
     values_.push_back(value);
+    std::vector<size_t> key;
+    std::vector<size_t> ids;
     for (size_t i = 0, S = sel->length(); i < S; ++i)
     {
-      hash_[(*sel)[i]].push_back(std::make_pair(sel, index));
+      // intern the simple selector
+      auto it = ids_.find((*sel)[i]);
+      if (it == ids_.end()) {
+        it = ids_.insert(std::make_pair((*sel)[i], index_.size())).first;
+        index_.push_back(std::vector<size_t>());
+      }
+      ids.push_back(it->second);
+      auto cl = classes_.find((*sel)[i]);
+      if (cl == classes_.end()) {
+        cl = classes_.insert(std::make_pair((*sel)[i], classes_.size())).first;
+      }
+      key.push_back(cl->second);
     }
+    std::sort(ids.begin(), ids.end());
+    ids.erase(std::unique(ids.begin(), ids.end()), ids.end());
+    for (size_t id : ids) index_[id].push_back(index);
+    std::sort(key.begin(), key.end());
+    key.erase(std::unique(key.begin(), key.end()), key.end());
+    keys_.push_back(key);
   }
 
   std::vector<SubSetMapPair> Subset_Map::get_kv(const Compound_Selector_Obj& sel)
   {
-    SimpleSelectorDict dict(sel->begin(), sel->end()); // XXX Set
-    std::vector<size_t> indices;
+    // mark the classes of the query (selectors that
+    // were never put can not be in any target)
+    std::vector<size_t> ids;
+    std::vector<size_t> classes;
+    if (marks.size() * 64 < classes_.size()) marks.resize(classes_.size() / 64 + 1);
     for (size_t i = 0, S = sel->length(); i < S; ++i) {
-      if (!hash_.count((*sel)[i])) {
-        continue;
-      }
-      const std::vector<std::pair<Compound_Selector_Obj, size_t> >& subsets = hash_[(*sel)[i]];
-      for (const std::pair<Compound_Selector_Obj, size_t>& item : subsets) {
+      auto it = ids_.find((*sel)[i]);
+      if (it != ids_.end()) ids.push_back(it->second);
+      auto cl = classes_.find((*sel)[i]);
+      if (cl == classes_.end()) continue;
+      size_t id = cl->second;
+      uint64_t bit = uint64_t(1) << (id % 64);
+      if (marks[id / 64] & bit) continue;
+      marks[id / 64] |= bit;
+      classes.push_back(id);
+    }
+    std::sort(ids.begin(), ids.end());
+    ids.erase(std::unique(ids.begin(), ids.end()), ids.end());
+
+    std::vector<size_t> indices;
+    for (size_t id : ids) {
+      for (size_t index : index_[id]) {
+        const std::vector<size_t>& key = keys_[index];
+        // the target must be a subset of the query
+        if (key.size() > classes.size()) continue;
         bool include = true;
-        for (const Simple_Selector_Obj& it : item.first->elements()) {
-          auto found = dict.find(it);
-          if (found == dict.end()) {
+        for (size_t k : key) {
+          if (!(marks[k / 64] & (uint64_t(1) << (k % 64)))) {
             include = false;
             break;
           }
         }
-        if (include) indices.push_back(item.second);
+        if (include) indices.push_back(index);
       }
     }
+    // all marks are from this query
+    for (size_t id : classes) marks[id / 64] = 0;
+
     sort(indices.begin(), indices.end());
     std::vector<size_t>::iterator indices_end = unique(indices.begin(), indices.end());
     indices.resize(distance(indices.begin(), indices_end));
 
     std::vector<SubSetMapPair> results;
+    results.reserve(indices.size());
     for (size_t i = 0, S = indices.size(); i < S; ++i) {
       results.push_back(values_[indices[i]]);
     }
@@ -52,4 +95,4 @@ namespace Sass {
     return get_kv(sel);
   }
 
-}
\ No newline at end of file
+}
@@ -6,6 +6,8 @@
 #include <vector>
 #include <algorithm>
 #include <iterator>
+#include <unordered_map>
+#include <stdint.h>
 
 #include "ast_fwd_decl.hpp"
 
@@ -58,16 +60,32 @@
 
 namespace Sass {
 
+  // Index of the extensions by the compound selectors they target.
+  // The simple selectors of the targets are interned twice: to ids
+  // by their order (like the keys of a std::map with OrderNodes) and
+  // to classes by equality (like a SimpleSelectorDict). A target is a
+  // candidate for a query if it shares an id with the query, and it
+  // matches if all of its classes are among the classes of the query.
+  // Note that `[x=y]` and `[x="y"]` are equal but not equivalent by
+  // their order, so both steps are needed to find the same matches.
+  // Queries do not modify the map (the bitset is per thread).
   class Subset_Map {
   private:
     std::vector<SubSetMapPair> values_;
-    std::map<Simple_Selector_Obj, std::vector<std::pair<Compound_Selector_Obj, size_t> >, OrderNodes > hash_;
+    // sorted classes of the target of each value
+    std::vector<std::vector<size_t> > keys_;
+    // ids of the simple selectors by their order
+    std::map<Simple_Selector_Obj, size_t, OrderNodes> ids_;
+    // classes of the simple selectors by equality
+    std::unordered_map<Simple_Selector_Obj, size_t, HashNodes, CompareNodes> classes_;
+    // values whose target contains the id
+    std::vector<std::vector<size_t> > index_;
   public:
     void put(const Compound_Selector_Obj& sel, const SubSetMapPair& value);
     std::vector<SubSetMapPair> get_kv(const Compound_Selector_Obj& s);
     std::vector<SubSetMapPair> get_v(const Compound_Selector_Obj& s);
     bool empty() { return values_.empty(); }
-    void clear() { values_.clear(); hash_.clear(); }
+    void clear() { values_.clear(); keys_.clear(); ids_.clear(); classes_.clear(); index_.clear(); }
     const std::vector<SubSetMapPair> values(void) { return values_; }
   };
 
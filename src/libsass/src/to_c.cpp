@@ -1,6 +1,7 @@
 #include "sass.hpp"
 #include "to_c.hpp"
 #include "ast.hpp"
+#include "sass_values.hpp"
 
 namespace Sass {
 
@@ -24,6 +25,9 @@ namespace Sass {
 
   union Sass_Value* To_C::operator()(String_Constant_Ptr s)
   {
+    if (borrow_strings) {
+      return make_borrowed_string(s->value().c_str(), s->quote_mark() != 0);
+    }
     if (s->quote_mark()) {
       return sass_make_qstring(s->value().c_str());
     } else {
@@ -32,7 +36,12 @@ namespace Sass {
   }
 
   union Sass_Value* To_C::operator()(String_Quoted_Ptr s)
-  { return sass_make_qstring(s->value().c_str()); }
+  {
+    if (borrow_strings) {
+      return make_borrowed_string(s->value().c_str(), true);
+    }
+    return sass_make_qstring(s->value().c_str());
+  }
 
   union Sass_Value* To_C::operator()(List_Ptr l)
   {
@@ -11,9 +11,15 @@ namespace Sass {
     // override this to define a catch-all
     union Sass_Value* fallback_impl(AST_Node_Ptr n);
 
+    // strings point into the converted nodes
+    bool borrow_strings;
+
   public:
 
-    To_C() { }
+    // values borrowing their strings must be deleted
+    // while the converted nodes are still alive
+    To_C(bool borrow_strings = false)
+    : borrow_strings(borrow_strings) { }
     ~To_C() { }
 
     union Sass_Value* operator()(Boolean_Ptr);
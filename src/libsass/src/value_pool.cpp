@@ -0,0 +1,114 @@
+#include "sass.hpp"
+#include <cstdlib>
+#include <cstring>
+
+#include "value_pool.hpp"
+
+namespace Sass {
+
+  // the pool entered on the calling thread
+  static thread_local Value_Pool* current = 0;
+
+  Value_Pool::Value_Pool()
+  : reused(0), recycled(0), outer(0)
+  {
+    for (size_t i = 0; i < CLASSES; ++i) {
+      free_blocks[i] = 0;
+      free_count[i] = 0;
+    }
+  }
+
+  Value_Pool::~Value_Pool()
+  {
+    clear();
+  }
+
+  void Value_Pool::enter()
+  {
+    outer = current;
+    current = this;
+  }
+
+  void Value_Pool::leave()
+  {
+    current = outer;
+    outer = 0;
+  }
+
+  void Value_Pool::clear()
+  {
+    for (size_t i = 0; i < CLASSES; ++i) {
+      while (Free_Block* block = free_blocks[i]) {
+        free_blocks[i] = block->next;
+        free(block);
+      }
+      free_count[i] = 0;
+    }
+  }
+
+  void* Value_Pool::allocate(size_t size)
+  {
+    // keep the behavior of calloc for empty lists
+    if (size == 0) return calloc(0, 1);
+    size_t index = (size - 1) / GRANULARITY;
+    if (index >= CLASSES) return calloc(1, size);
+    size_t rounded = (index + 1) * GRANULARITY;
+    Value_Pool* pool = current;
+    if (pool && pool->free_blocks[index]) {
+      Free_Block* block = pool->free_blocks[index];
+      pool->free_blocks[index] = block->next;
+      -- pool->free_count[index];
+      ++ pool->reused;
+      return memset(block, 0, rounded);
+    }
+    return calloc(1, rounded);
+  }
+
+  void Value_Pool::release(void* block, size_t size)
+  {
+    if (block == 0) return;
+    size_t index = (size - 1) / GRANULARITY;
+    Value_Pool* pool = current;
+    if (size == 0 || index >= CLASSES || !pool || pool->free_count[index] >= MAX_FREE) {
+      free(block);
+      return;
+    }
+    Free_Block* free_block = static_cast<Free_Block*>(block);
+    free_block->next = pool->free_blocks[index];
+    pool->free_blocks[index] = free_block;
+    ++ pool->free_count[index];
+    ++ pool->recycled;
+  }
+
+}
+
+extern "C" {
+  using namespace Sass;
+
+  struct Sass_Value_Pool* ADDCALL sass_make_value_pool(void)
+  {
+    try { return new Sass_Value_Pool(); }
+    catch (...) { return 0; }
+  }
+
+  void ADDCALL sass_delete_value_pool(struct Sass_Value_Pool* pool)
+  {
+    delete pool;
+  }
+
+  void ADDCALL sass_value_pool_enter(struct Sass_Value_Pool* pool)
+  {
+    if (pool) pool->enter();
+  }
+
+  void ADDCALL sass_value_pool_leave(struct Sass_Value_Pool* pool)
+  {
+    if (pool) pool->leave();
+  }
+
+  void ADDCALL sass_value_pool_clear(struct Sass_Value_Pool* pool)
+  {
+    if (pool) pool->clear();
+  }
+
+}
@@ -0,0 +1,62 @@
+#ifndef SASS_VALUE_POOL_H
+#define SASS_VALUE_POOL_H
+
+#include <cstddef>
+
+namespace Sass {
+
+  // Recycles the memory of C-API values (the `Sass_Value` unions and
+  // the item arrays of lists and maps). A pool is used by the thread
+  // it was entered on: values made there take blocks from the pool,
+  // values deleted there give their blocks back to it. All blocks are
+  // plain heap blocks of a rounded size, so values can still be made
+  // and deleted on threads that use another pool or none at all.
+  // Only a bounded number of blocks is kept, the rest is freed.
+  class Value_Pool {
+    public:
+      Value_Pool();
+      ~Value_Pool();
+      // make this the pool of the calling thread
+      // (pools are left in the reverse order)
+      void enter();
+      void leave();
+      // free all recycled blocks
+      void clear();
+      // zeroed block of at least `size` bytes
+      static void* allocate(size_t size);
+      // give back a block of `allocate(size)`
+      static void release(void* block, size_t size);
+      // statistics (blocks taken from and given back to the pool)
+      size_t get_reused() { return reused; }
+      size_t get_recycled() { return recycled; }
+    public:
+      // enters the pool for the lifetime of the scope
+      class Scope {
+        public:
+          Scope(Value_Pool& pool) : pool(pool) { pool.enter(); }
+          ~Scope() { pool.leave(); }
+        private:
+          Value_Pool& pool;
+      };
+    private:
+      // blocks are rounded up to the granularity,
+      // bigger blocks are not recycled
+      static const size_t GRANULARITY = 16;
+      static const size_t CLASSES = 16;
+      // blocks kept per size class
+      static const size_t MAX_FREE = 4096;
+      struct Free_Block { Free_Block* next; };
+      Free_Block* free_blocks[CLASSES];
+      size_t free_count[CLASSES];
+      size_t reused;
+      size_t recycled;
+      // pool of the thread before this one was entered
+      Value_Pool* outer;
+  };
+
+}
+
+// C-API handle for a value pool
+struct Sass_Value_Pool : Sass::Value_Pool { };
+
+#endif
@@ -0,0 +1,72 @@
+#include <nan.h>
+#include <string.h>
+#include "call_dispatcher.h"
+#include "output_sink.h"
+#include "sass_context_wrapper.h"
+#include "take_buffer.h"
+
+// A chunk of an async render waiting for the JavaScript thread
+class OutputChunk : public CallDispatcher::Call {
+  public:
+    OutputChunk(sass_context_wrapper* ctx_w, const char* chunk, size_t length)
+      : ctx_w(ctx_w), length(length) {
+      data = static_cast<char*>(sass_alloc_memory(length));
+      memcpy(data, chunk, length);
+    }
+
+    void dispatch() {
+      /*
+       * Function called in the main thread,
+       * before the render is finished.
+       */
+      Nan::TryCatch try_catch;
+      v8::Local<v8::Value> argv[] = {
+        take_buffer(data, length)
+      };
+      ctx_w->output_callback->Call(1, argv, ctx_w->async_resource);
+      if (try_catch.HasCaught()) {
+        Nan::FatalException(try_catch);
+      }
+      delete this;
+    }
+
+    void cancel() {
+      // the environment is gone, nothing can take the chunk
+      sass_free_memory(data);
+      delete this;
+    }
+
+  private:
+    sass_context_wrapper* ctx_w;
+    char* data;
+    size_t length;
+};
+
+void sass_output_sink(const char* chunk, size_t length, void* cookie) {
+  sass_context_wrapper* ctx_w = static_cast<sass_context_wrapper*>(cookie);
+
+  if (length == 0) return;
+
+  if (ctx_w->is_sync) {
+    /*
+     * This is invoked from the main JavaScript thread.
+     * V8 context is available.
+     */
+    Nan::HandleScope scope;
+    Nan::TryCatch try_catch;
+    v8::Local<v8::Value> argv[] = {
+      Nan::CopyBuffer(chunk, static_cast<uint32_t>(length)).ToLocalChecked()
+    };
+    Nan::Call(*ctx_w->output_callback, 1, argv);
+    if (try_catch.HasCaught()) {
+      Nan::FatalException(try_catch);
+    }
+  }
+  else {
+    /*
+     * This is invoked from a compile thread.
+     * No V8 context and functions available.
+     */
+    ctx_w->dispatcher->enqueue(new OutputChunk(ctx_w, chunk, length));
+  }
+}
@@ -0,0 +1,12 @@
+#ifndef OUTPUT_SINK_H
+#define OUTPUT_SINK_H
+
+#include <stddef.h>
+
+// Sink of libsass handing chunks of the css to the output
+// callback of the context wrapper given as its cookie. Chunks
+// of async renders are queued on the dispatcher and arrive
+// in order, before the render callback.
+void sass_output_sink(const char* chunk, size_t length, void* cookie);
+
+#endif
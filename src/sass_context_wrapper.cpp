@@ -1,17 +1,47 @@
 #include "sass_context_wrapper.h"
+#include "compiler.h"
 
 extern "C" {
   using namespace std;
 
-  void compile_it(uv_work_t* req) {
-    sass_context_wrapper* ctx_w = (sass_context_wrapper*)req->data;
+  void compile_it(void* data) {
+    sass_context_wrapper* ctx_w = (sass_context_wrapper*)data;
+    struct Sass_Context* ctx = ctx_w->dctx ? sass_data_context_get_context(ctx_w->dctx) : sass_file_context_get_context(ctx_w->fctx);
 
-    if (ctx_w->dctx) {
-      compile_data(ctx_w->dctx);
-    }
-    else if (ctx_w->fctx) {
-      compile_file(ctx_w->fctx);
+    // a context with an error is not compiled (as in sass_compile_*_context)
+    if (sass_context_get_error_status(ctx)) return;
+
+    // compiled step by step, so stop_it can reach the compiler
+    struct Sass_Compiler* compiler = ctx_w->dctx ? sass_make_data_compiler(ctx_w->dctx) : sass_make_file_compiler(ctx_w->fctx);
+
+    uv_mutex_lock(&ctx_w->stop_mutex);
+    bool stopped = ctx_w->stopped;
+    if (!stopped) ctx_w->running = compiler;
+    uv_mutex_unlock(&ctx_w->stop_mutex);
+
+    if (!stopped) {
+      sass_compiler_parse(compiler);
+      sass_compiler_execute(compiler);
     }
+
+    uv_mutex_lock(&ctx_w->stop_mutex);
+    ctx_w->running = 0;
+    uv_mutex_unlock(&ctx_w->stop_mutex);
+
+    sass_delete_compiler(compiler);
+  }
+
+  void stop_it(void* data) {
+    sass_context_wrapper* ctx_w = (sass_context_wrapper*)data;
+
+    uv_mutex_lock(&ctx_w->stop_mutex);
+    ctx_w->stopped = true;
+    if (ctx_w->running) sass_compiler_cancel(ctx_w->running);
+    uv_mutex_unlock(&ctx_w->stop_mutex);
+  }
+
+  void free_it(void* data) {
+    sass_free_context_wrapper((sass_context_wrapper*)data);
   }
 
   void compile_data(struct Sass_Data_Context* dctx) {
@@ -23,10 +53,16 @@ extern "C" {
   }
 
   sass_context_wrapper* sass_make_context_wrapper() {
-    return (sass_context_wrapper*)calloc(1, sizeof(sass_context_wrapper));
+    sass_context_wrapper* ctx_w = (sass_context_wrapper*)calloc(1, sizeof(sass_context_wrapper));
+    uv_mutex_init(&ctx_w->stop_mutex);
+    return ctx_w;
   }
 
   void sass_free_context_wrapper(sass_context_wrapper* ctx_w) {
+    if (ctx_w->compiler) {
+      // bridges are kept for the next render
+      ctx_w->compiler->finish(ctx_w);
+    }
     if (ctx_w->dctx) {
       sass_delete_data_context(ctx_w->dctx);
     }
@@ -39,6 +75,7 @@ extern "C" {
 
     delete ctx_w->error_callback;
     delete ctx_w->success_callback;
+    delete ctx_w->output_callback;
 
     ctx_w->result.Reset();
 
@@ -48,6 +85,7 @@ extern "C" {
     free(ctx_w->source_map);
     free(ctx_w->source_map_root);
     free(ctx_w->indent);
+    uv_mutex_destroy(&ctx_w->stop_mutex);
 
     std::vector<CustomImporterBridge *>::iterator imp_it = ctx_w->importer_bridges.begin();
     while (imp_it != ctx_w->importer_bridges.end()) {
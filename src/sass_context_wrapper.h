@@ -8,6 +8,9 @@
 #include <sass/context.h>
 #include "custom_function_bridge.h"
 #include "custom_importer_bridge.h"
+#include "call_dispatcher.h"
+
+class Compiler;
 
 #ifdef __cplusplus
 extern "C" {
@@ -15,7 +18,11 @@ extern "C" {
 
   void compile_data(struct Sass_Data_Context* dctx);
   void compile_file(struct Sass_File_Context* fctx);
-  void compile_it(uv_work_t* req);
+  void compile_it(void* data);
+  // stops a render running in compile_it early (any thread)
+  void stop_it(void* data);
+  // frees the wrapper of a render whose result is dropped
+  void free_it(void* data);
 
   struct sass_context_wrapper {
     // binding related
@@ -32,19 +39,30 @@ extern "C" {
     // libsass related
     Sass_Data_Context* dctx;
     Sass_File_Context* fctx;
+    // guards the fields below (compile_it and stop_it)
+    uv_mutex_t stop_mutex;
+    Sass_Compiler* running;
+    bool stopped;
 
     // libuv related
     uv_async_t async;
-    uv_work_t request;
 
     // v8 and nan related
     Nan::Persistent<v8::Object> result;
     Nan::AsyncResource* async_resource;
     Nan::Callback* error_callback;
     Nan::Callback* success_callback;
+    // receives the css in chunks (optional)
+    Nan::Callback* output_callback;
+    // runs the chunks of async renders
+    CallDispatcher* dispatcher;
 
     std::vector<CustomFunctionBridge *> function_bridges;
     std::vector<CustomImporterBridge *> importer_bridges;
+
+    // owner of the bridges and settings (null unless
+    // rendered through a compiler handle)
+    Compiler* compiler;
   };
 
   struct sass_context_wrapper*      sass_make_context_wrapper(void);
@@ -1,22 +1,23 @@
 #include <nan.h>
 #include "boolean.h"
+#include "../addon_data.h"
 
 namespace SassTypes
 {
-  Nan::Persistent<v8::Function> Boolean::constructor;
-  bool Boolean::constructor_locked = false;
-
   Boolean::Boolean(bool _value) {
     value = sass_make_boolean(_value);
   }
 
   Boolean& Boolean::get_singleton(bool v) {
+    // shared by all environments, each has its own JS objects
     static Boolean instance_false(false), instance_true(true);
     return v ? instance_true : instance_false;
   }
 
   v8::Local<v8::Function> Boolean::get_constructor() {
     Nan::EscapableHandleScope scope;
+    AddonData* data = AddonData::current();
+    Nan::Persistent<v8::Function>& constructor = data->constructor<Boolean>();
     v8::Local<v8::Function> conslocal;
     if (constructor.IsEmpty()) {
       v8::Local<v8::FunctionTemplate> tpl = Nan::New<v8::FunctionTemplate>(New);
@@ -28,15 +29,17 @@ namespace SassTypes
       conslocal = Nan::GetFunction(tpl).ToLocalChecked();
       constructor.Reset(conslocal);
 
-      get_singleton(false).js_object.Reset(Nan::NewInstance(conslocal).ToLocalChecked());
-      Nan::SetInternalFieldPointer(Nan::New(get_singleton(false).js_object), 0, &get_singleton(false));
-      Nan::Set(conslocal, Nan::New("FALSE").ToLocalChecked(), Nan::New(get_singleton(false).js_object));
+      v8::Local<v8::Object> instance_false = Nan::NewInstance(conslocal).ToLocalChecked();
+      Nan::SetInternalFieldPointer(instance_false, 0, &get_singleton(false));
+      Nan::Set(conslocal, Nan::New("FALSE").ToLocalChecked(), instance_false);
 
-      get_singleton(true).js_object.Reset(Nan::NewInstance(conslocal).ToLocalChecked());
-      Nan::SetInternalFieldPointer(Nan::New(get_singleton(true).js_object), 0, &get_singleton(true));
-      Nan::Set(conslocal, Nan::New("TRUE").ToLocalChecked(), Nan::New(get_singleton(true).js_object));
+      v8::Local<v8::Object> instance_true = Nan::NewInstance(conslocal).ToLocalChecked();
+      Nan::SetInternalFieldPointer(instance_true, 0, &get_singleton(true));
+      Nan::Set(conslocal, Nan::New("TRUE").ToLocalChecked(), instance_true);
 
-      constructor_locked = true;
+      // no more instances from here on
+      data->sass_false.Reset(instance_false);
+      data->sass_true.Reset(instance_true);
     } else {
       conslocal = Nan::New(constructor);
     }
@@ -45,7 +48,11 @@ namespace SassTypes
   }
 
   v8::Local<v8::Object> Boolean::get_js_object() {
-    return Nan::New(this->js_object);
+    AddonData* data = AddonData::current();
+    if (data->sass_true.IsEmpty()) {
+      get_constructor();
+    }
+    return Nan::New(sass_boolean_get_value(this->value) ? data->sass_true : data->sass_false);
   }
 
   v8::Local<v8::Boolean> Boolean::get_js_boolean() {
@@ -54,7 +61,7 @@ namespace SassTypes
 
   NAN_METHOD(Boolean::New) {
     if (info.IsConstructCall()) {
-      if (constructor_locked) {
+      if (!AddonData::current()->sass_true.IsEmpty()) {
         return Nan::ThrowTypeError("Cannot instantiate SassBoolean");
       }
     }
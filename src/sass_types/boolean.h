@@ -12,6 +12,7 @@ namespace SassTypes
       static Boolean& get_singleton(bool);
       static v8::Local<v8::Function> get_constructor();
 
+      // the instance of the current environment
       v8::Local<v8::Object> get_js_object();
 
       static NAN_METHOD(New);
@@ -20,10 +21,6 @@ namespace SassTypes
     private:
       Boolean(bool);
 
-      Nan::Persistent<v8::Object> js_object;
-
-      static Nan::Persistent<v8::Function> constructor;
-      static bool constructor_locked;
       v8::Local<v8::Boolean> get_js_boolean();
   };
 }
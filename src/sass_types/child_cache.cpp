@@ -0,0 +1,60 @@
+#include <nan.h>
+#include "child_cache.h"
+#include "factory.h"
+
+namespace SassTypes
+{
+  static v8::Local<v8::String> children_key() {
+    return Nan::New("node-sass:children").ToLocalChecked();
+  }
+
+  static v8::Local<v8::String> owner_key() {
+    return Nan::New("node-sass:owner").ToLocalChecked();
+  }
+
+  v8::Local<v8::Object> ChildCache::get(v8::Local<v8::Object> owner, size_t slot, Sass_Value* item) {
+    Nan::EscapableHandleScope scope;
+
+    v8::Local<v8::Value> children = Nan::GetPrivate(owner, children_key()).ToLocalChecked();
+    if (!children->IsArray()) {
+      children = Nan::New<v8::Array>();
+      Nan::SetPrivate(owner, children_key(), children);
+    }
+
+    v8::Local<v8::Array> array = children.As<v8::Array>();
+    uint32_t index = static_cast<uint32_t>(slot);
+    v8::Local<v8::Value> cached = Nan::Get(array, index).ToLocalChecked();
+    if (cached->IsObject()) {
+      return scope.Escape(cached.As<v8::Object>());
+    }
+
+    // booleans and null are singletons with storage of their own
+    bool shared = !sass_value_is_boolean(item) && !sass_value_is_null(item);
+    v8::Local<v8::Object> wrapper = Factory::create(item, shared)->get_js_object();
+    if (shared) Nan::SetPrivate(wrapper, owner_key(), owner);
+    Nan::Set(array, index, wrapper);
+    return scope.Escape(wrapper);
+  }
+
+  void ChildCache::release(v8::Local<v8::Object> owner, size_t slot, Sass_Value* item) {
+    Nan::HandleScope scope;
+
+    // items of new lists and maps are unset until assigned
+    if (!item) return;
+
+    v8::Local<v8::Value> children = Nan::GetPrivate(owner, children_key()).ToLocalChecked();
+    if (children->IsArray()) {
+      v8::Local<v8::Array> array = children.As<v8::Array>();
+      uint32_t index = static_cast<uint32_t>(slot);
+      v8::Local<v8::Value> cached = Nan::Get(array, index).ToLocalChecked();
+      Nan::Set(array, index, Nan::Undefined());
+      Value* wrapped = cached->IsObject() ? Factory::unwrap(cached) : 0;
+      if (wrapped && wrapped->adopt()) {
+        Nan::DeletePrivate(cached.As<v8::Object>(), owner_key());
+        return;
+      }
+    }
+
+    sass_delete_value(item);
+  }
+}
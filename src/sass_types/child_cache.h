@@ -0,0 +1,27 @@
+#ifndef SASS_TYPES_CHILD_CACHE_H
+#define SASS_TYPES_CHILD_CACHE_H
+
+#include <nan.h>
+#include <sass/values.h>
+
+namespace SassTypes
+{
+  // Wrappers of the items of a list or map, created on first access
+  // and handed out again on later ones (instead of a new wrapper and
+  // a new copy of the item per call). A wrapper shares the storage of
+  // its item, so changes made through it show in the list or map, and
+  // it keeps its owner alive; once the item is replaced, the wrapper
+  // takes it over. Wrappers and owners only refer to each other from
+  // their JavaScript objects, so the garbage collector frees them
+  // together. Slots are indexes chosen by the owner.
+  class ChildCache {
+    public:
+      // The wrapper of `item` in `slot` of `owner`
+      static v8::Local<v8::Object> get(v8::Local<v8::Object> owner, size_t slot, Sass_Value* item);
+      // The item in `slot` of `owner` is about to be replaced, its
+      // wrapper takes it over (the item is deleted if there is none)
+      static void release(v8::Local<v8::Object> owner, size_t slot, Sass_Value* item);
+  };
+}
+
+#endif
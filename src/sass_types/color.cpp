@@ -3,7 +3,7 @@
 
 namespace SassTypes
 {
-  Color::Color(Sass_Value* v) : SassValueWrapper(v) {}
+  Color::Color(Sass_Value* v, bool shared) : SassValueWrapper(v, shared) {}
 
   Sass_Value* Color::construct(const std::vector<v8::Local<v8::Value>> raw_val, Sass_Value **out) {
     double a = 1.0, r = 0, g = 0, b = 0;
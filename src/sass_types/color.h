@@ -14,7 +14,7 @@ namespace SassTypes
 {
   class Color : public SassValueWrapper<Color> {
     public:
-      Color(Sass_Value*);
+      Color(Sass_Value*, bool shared = false);
       static char const* get_constructor_name() { return "SassColor"; }
       static Sass_Value* construct(const std::vector<v8::Local<v8::Value>>, Sass_Value **);
 
@@ -8,7 +8,7 @@ namespace SassTypes
 {
   class Error : public SassValueWrapper<Error> {
     public:
-      Error(Sass_Value*);
+      Error(Sass_Value*, bool shared = false);
       static char const* get_constructor_name() { return "SassError"; }
       static Sass_Value* construct(const std::vector<v8::Local<v8::Value>>, Sass_Value **);
 
@@ -12,31 +12,31 @@
 
 namespace SassTypes
 {
-  SassTypes::Value* Factory::create(Sass_Value* v) {
+  SassTypes::Value* Factory::create(Sass_Value* v, bool shared) {
     switch (sass_value_get_tag(v)) {
     case SASS_NUMBER:
-      return new Number(v);
+      return new Number(v, shared);
 
     case SASS_STRING:
-      return new String(v);
+      return new String(v, shared);
 
     case SASS_COLOR:
-      return new Color(v);
+      return new Color(v, shared);
 
     case SASS_BOOLEAN:
       return &Boolean::get_singleton(sass_boolean_get_value(v));
 
     case SASS_LIST:
-      return new List(v);
+      return new List(v, shared);
 
     case SASS_MAP:
-      return new Map(v);
+      return new Map(v, shared);
 
     case SASS_NULL:
       return &Null::get_singleton();
 
     case SASS_ERROR:
-      return new Error(v);
+      return new Error(v, shared);
 
     default:
       const char *msg = "Unknown type encountered.";
@@ -60,6 +60,70 @@ namespace SassTypes
     Nan::Set(target, Nan::New<v8::String>("types").ToLocalChecked(), types);
   }
 
+  static v8::Local<v8::String> stringify(const Sass_Value* v) {
+    Sass_Value* str = sass_value_stringify(v, false, 5);
+    v8::Local<v8::String> rv = Nan::New<v8::String>(sass_string_get_value(str)).ToLocalChecked();
+    sass_delete_value(str);
+    return rv;
+  }
+
+  v8::Local<v8::Value> Factory::to_plain(const Sass_Value* v) {
+    Nan::EscapableHandleScope scope;
+
+    // items of new lists and maps are unset until assigned
+    if (!v) return scope.Escape(Nan::Undefined());
+
+    switch (sass_value_get_tag(v)) {
+    case SASS_NUMBER: {
+      const char* unit = sass_number_get_unit(v);
+      if (!unit || !*unit) {
+        return scope.Escape(Nan::New<v8::Number>(sass_number_get_value(v)));
+      }
+      return scope.Escape(stringify(v));
+    }
+
+    case SASS_STRING:
+      return scope.Escape(Nan::New<v8::String>(sass_string_get_value(v)).ToLocalChecked());
+
+    case SASS_BOOLEAN:
+      return scope.Escape(Nan::New<v8::Boolean>(sass_boolean_get_value(v)));
+
+    case SASS_LIST: {
+      size_t length = sass_list_get_length(v);
+      v8::Local<v8::Array> array = Nan::New<v8::Array>(static_cast<int>(length));
+      for (size_t i = 0; i < length; ++i) {
+        Nan::Set(array, static_cast<uint32_t>(i), to_plain(sass_list_get_value(v, i)));
+      }
+      return scope.Escape(array);
+    }
+
+    case SASS_MAP: {
+      v8::Local<v8::Object> object = Nan::New<v8::Object>();
+      for (size_t i = 0, L = sass_map_get_length(v); i < L; ++i) {
+        const Sass_Value* key = sass_map_get_key(v, i);
+        if (!key) continue;
+        v8::Local<v8::String> name = sass_value_is_string(key)
+          ? Nan::New<v8::String>(sass_string_get_value(key)).ToLocalChecked()
+          : stringify(key);
+        Nan::Set(object, name, to_plain(sass_map_get_value(v, i)));
+      }
+      return scope.Escape(object);
+    }
+
+    case SASS_NULL:
+      return scope.Escape(Nan::Null());
+
+    case SASS_ERROR:
+      return scope.Escape(Nan::New<v8::String>(sass_error_get_message(v)).ToLocalChecked());
+
+    case SASS_WARNING:
+      return scope.Escape(Nan::New<v8::String>(sass_warning_get_message(v)).ToLocalChecked());
+
+    default:
+      return scope.Escape(stringify(v));
+    }
+  }
+
   Value* Factory::unwrap(v8::Local<v8::Value> obj) {
       if (obj->IsObject()) {
           v8::Local<v8::Object> v8_obj = obj.As<v8::Object>();
@@ -12,8 +12,14 @@ namespace SassTypes
   class Factory {
     public:
       static NAN_MODULE_INIT(initExports);
-      static Value* create(Sass_Value*);
+      // The wrapper of a copy of the value (or of the value itself
+      // if `shared`, which is then owned by a list or map)
+      static Value* create(Sass_Value*, bool shared = false);
       static Value* unwrap(v8::Local<v8::Value>);
+      // Converts a value into plain JavaScript data in one pass
+      // (lists to arrays, maps to objects, numbers with units and
+      // colors to their css text)
+      static v8::Local<v8::Value> to_plain(const Sass_Value*);
   };
 }
 
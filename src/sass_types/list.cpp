@@ -3,7 +3,7 @@
 
 namespace SassTypes
 {
-  List::List(Sass_Value* v) : SassValueWrapper(v) {}
+  List::List(Sass_Value* v, bool shared) : SassValueWrapper(v, shared) {}
 
   Sass_Value* List::construct(const std::vector<v8::Local<v8::Value>> raw_val, Sass_Value **out) {
     size_t length = 0;
@@ -35,6 +35,7 @@ namespace SassTypes
     Nan::SetPrototypeMethod(proto, "setSeparator", SetSeparator);
     Nan::SetPrototypeMethod(proto, "getValue", GetValue);
     Nan::SetPrototypeMethod(proto, "setValue", SetValue);
+    Nan::SetPrototypeMethod(proto, "toArray", ToArray);
   }
 
   NAN_METHOD(List::GetValue) {
@@ -47,15 +48,15 @@ namespace SassTypes
       return Nan::ThrowTypeError("Supplied index should be an integer");
     }
 
-    Sass_Value* list = List::Unwrap<List>(info.This())->value;
+    List* self = List::Unwrap<List>(info.This());
     size_t index = Nan::To<uint32_t>(info[0]).FromJust();
 
 
-    if (index >= sass_list_get_length(list)) {
+    if (index >= sass_list_get_length(self->value)) {
       return Nan::ThrowRangeError(Nan::New("Out of bound index").ToLocalChecked());
     }
 
-    info.GetReturnValue().Set(Factory::create(sass_list_get_value(list, Nan::To<uint32_t>(info[0]).FromJust()))->get_js_object());
+    info.GetReturnValue().Set(ChildCache::get(info.This(), index, sass_list_get_value(self->value, index)));
   }
 
   NAN_METHOD(List::SetValue) {
@@ -73,7 +74,13 @@ namespace SassTypes
 
     Value* sass_value = Factory::unwrap(info[1]);
     if (sass_value) {
-      sass_list_set_value(List::Unwrap<List>(info.This())->value, Nan::To<uint32_t>(info[0]).FromJust(), sass_value->get_sass_value());
+      List* self = List::Unwrap<List>(info.This());
+      size_t index = Nan::To<uint32_t>(info[0]).FromJust();
+      if (index >= sass_list_get_length(self->value)) {
+        return Nan::ThrowRangeError(Nan::New("Out of bound index").ToLocalChecked());
+      }
+      ChildCache::release(info.This(), index, sass_list_get_value(self->value, index));
+      sass_list_set_value(self->value, index, sass_value->get_sass_value());
     } else {
       Nan::ThrowTypeError("A SassValue is expected as the list item");
     }
@@ -98,4 +105,8 @@ namespace SassTypes
   NAN_METHOD(List::GetLength) {
     info.GetReturnValue().Set(Nan::New<v8::Number>(sass_list_get_length(List::Unwrap<List>(info.This())->value)));
   }
+
+  NAN_METHOD(List::ToArray) {
+    info.GetReturnValue().Set(Factory::to_plain(List::Unwrap<List>(info.This())->value));
+  }
 }
@@ -3,12 +3,13 @@
 
 #include <nan.h>
 #include "sass_value_wrapper.h"
+#include "child_cache.h"
 
 namespace SassTypes
 {
   class List : public SassValueWrapper<List> {
     public:
-      List(Sass_Value*);
+      List(Sass_Value*, bool shared = false);
       static char const* get_constructor_name() { return "SassList"; }
       static Sass_Value* construct(const std::vector<v8::Local<v8::Value>>, Sass_Value **);
 
@@ -19,6 +20,7 @@ namespace SassTypes
       static NAN_METHOD(GetSeparator);
       static NAN_METHOD(SetSeparator);
       static NAN_METHOD(GetLength);
+      static NAN_METHOD(ToArray);
   };
 }
 
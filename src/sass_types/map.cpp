@@ -3,7 +3,7 @@
 
 namespace SassTypes
 {
-  Map::Map(Sass_Value* v) : SassValueWrapper(v) {}
+  Map::Map(Sass_Value* v, bool shared) : SassValueWrapper(v, shared), indexed(false) {}
 
   Sass_Value* Map::construct(const std::vector<v8::Local<v8::Value>> raw_val, Sass_Value **out) {
     size_t length = 0;
@@ -25,6 +25,51 @@ namespace SassTypes
     Nan::SetPrototypeMethod(proto, "setKey", SetKey);
     Nan::SetPrototypeMethod(proto, "getValue", GetValue);
     Nan::SetPrototypeMethod(proto, "setValue", SetValue);
+    Nan::SetPrototypeMethod(proto, "getValueByKey", GetValueByKey);
+    Nan::SetPrototypeMethod(proto, "toObject", ToObject);
+  }
+
+  void Map::build_index() {
+    positions.clear();
+    for (size_t i = 0, L = sass_map_get_length(value); i < L; ++i) {
+      const Sass_Value* key = sass_map_get_key(value, i);
+      // quoted and unquoted strings are the same key, the first one wins
+      if (key && sass_value_is_string(key)) positions.emplace(sass_string_get_value(key), i);
+    }
+    indexed = true;
+  }
+
+  size_t Map::find(v8::Local<v8::Value> key) {
+    size_t length = sass_map_get_length(value);
+    size_t position = length;
+
+    if (key->IsString()) {
+      if (!indexed) build_index();
+      Nan::Utf8String name(key);
+      auto it = positions.find(std::string(*name, name.length()));
+      return it == positions.end() ? length : it->second;
+    }
+
+    Value* wrapped = Factory::unwrap(key);
+    if (!wrapped) return length;
+
+    Sass_Value* sass_key = wrapped->get_sass_value();
+    if (sass_value_is_string(sass_key)) {
+      if (!indexed) build_index();
+      auto it = positions.find(sass_string_get_value(sass_key));
+      if (it != positions.end()) position = it->second;
+    }
+    else {
+      // other keys are compared the way sass does
+      for (size_t i = 0; i < length && position == length; ++i) {
+        if (!sass_map_get_key(value, i)) continue;
+        Sass_Value* equal = sass_value_op(EQ, sass_map_get_key(value, i), sass_key);
+        if (sass_value_is_boolean(equal) && sass_boolean_get_value(equal)) position = i;
+        sass_delete_value(equal);
+      }
+    }
+    sass_delete_value(sass_key);
+    return position;
   }
 
   NAN_METHOD(Map::GetValue) {
@@ -37,15 +82,15 @@ namespace SassTypes
       return Nan::ThrowTypeError("Supplied index should be an integer");
     }
 
-    Sass_Value* map = Map::Unwrap<Map>(info.This())->value;
+    Map* self = Map::Unwrap<Map>(info.This());
     size_t index = Nan::To<uint32_t>(info[0]).FromJust();
 
 
-    if (index >= sass_map_get_length(map)) {
+    if (index >= sass_map_get_length(self->value)) {
       return Nan::ThrowRangeError(Nan::New("Out of bound index").ToLocalChecked());
     }
 
-    info.GetReturnValue().Set(Factory::create(sass_map_get_value(map, Nan::To<uint32_t>(info[0]).FromJust()))->get_js_object());
+    info.GetReturnValue().Set(ChildCache::get(info.This(), index, sass_map_get_value(self->value, index)));
   }
 
   NAN_METHOD(Map::SetValue) {
@@ -63,7 +108,13 @@ namespace SassTypes
 
     Value* sass_value = Factory::unwrap(info[1]);
     if (sass_value) {
-      sass_map_set_value(Map::Unwrap<Map>(info.This())->value, Nan::To<uint32_t>(info[0]).FromJust(), sass_value->get_sass_value());
+      Map* self = Map::Unwrap<Map>(info.This());
+      size_t index = Nan::To<uint32_t>(info[0]).FromJust();
+      if (index >= sass_map_get_length(self->value)) {
+        return Nan::ThrowRangeError(Nan::New("Out of bound index").ToLocalChecked());
+      }
+      ChildCache::release(info.This(), index, sass_map_get_value(self->value, index));
+      sass_map_set_value(self->value, index, sass_value->get_sass_value());
     } else {
       Nan::ThrowTypeError("A SassValue is expected as a map value");
     }
@@ -78,17 +129,16 @@ namespace SassTypes
       return Nan::ThrowTypeError("Supplied index should be an integer");
     }
 
-    Sass_Value* map = Map::Unwrap<Map>(info.This())->value;
+    Map* self = Map::Unwrap<Map>(info.This());
     size_t index = Nan::To<uint32_t>(info[0]).FromJust();
 
 
-    if (index >= sass_map_get_length(map)) {
+    if (index >= sass_map_get_length(self->value)) {
       return Nan::ThrowRangeError(Nan::New("Out of bound index").ToLocalChecked());
     }
 
-    SassTypes::Value* obj = Factory::create(sass_map_get_key(map, Nan::To<uint32_t>(info[0]).FromJust()));
-    v8::Local<v8::Object> js_obj = obj->get_js_object();
-    info.GetReturnValue().Set(js_obj);
+    // keys are copies, the index would miss keys changed in place
+    info.GetReturnValue().Set(Factory::create(sass_map_get_key(self->value, index))->get_js_object());
   }
 
   NAN_METHOD(Map::SetKey) {
@@ -106,7 +156,15 @@ namespace SassTypes
 
     Value* sass_value = Factory::unwrap(info[1]);
     if (sass_value) {
-      sass_map_set_key(Map::Unwrap<Map>(info.This())->value, Nan::To<uint32_t>(info[0]).FromJust(), sass_value->get_sass_value());
+      Map* self = Map::Unwrap<Map>(info.This());
+      size_t index = Nan::To<uint32_t>(info[0]).FromJust();
+      if (index >= sass_map_get_length(self->value)) {
+        return Nan::ThrowRangeError(Nan::New("Out of bound index").ToLocalChecked());
+      }
+      Sass_Value* key = sass_map_get_key(self->value, index);
+      sass_map_set_key(self->value, index, sass_value->get_sass_value());
+      if (key) sass_delete_value(key);
+      self->indexed = false;
     } else {
       Nan::ThrowTypeError("A SassValue is expected as a map key");
     }
@@ -115,4 +173,23 @@ namespace SassTypes
   NAN_METHOD(Map::GetLength) {
     info.GetReturnValue().Set(Nan::New<v8::Number>(sass_map_get_length(Map::Unwrap<Map>(info.This())->value)));
   }
+
+  NAN_METHOD(Map::GetValueByKey) {
+    if (info.Length() != 1) {
+      return Nan::ThrowTypeError("Expected just one argument");
+    }
+
+    Map* self = Map::Unwrap<Map>(info.This());
+    size_t index = self->find(info[0]);
+
+    if (index >= sass_map_get_length(self->value)) {
+      return info.GetReturnValue().SetUndefined();
+    }
+
+    info.GetReturnValue().Set(ChildCache::get(info.This(), index, sass_map_get_value(self->value, index)));
+  }
+
+  NAN_METHOD(Map::ToObject) {
+    info.GetReturnValue().Set(Factory::to_plain(Map::Unwrap<Map>(info.This())->value));
+  }
 }
@@ -1,14 +1,17 @@
 #ifndef SASS_TYPES_MAP_H
 #define SASS_TYPES_MAP_H
 
+#include <string>
+#include <unordered_map>
 #include <nan.h>
 #include "sass_value_wrapper.h"
+#include "child_cache.h"
 
 namespace SassTypes
 {
   class Map : public SassValueWrapper<Map> {
     public:
-      Map(Sass_Value*);
+      Map(Sass_Value*, bool shared = false);
       static char const* get_constructor_name() { return "SassMap"; }
       static Sass_Value* construct(const std::vector<v8::Local<v8::Value>>, Sass_Value **);
 
@@ -19,6 +22,17 @@ namespace SassTypes
       static NAN_METHOD(GetKey);
       static NAN_METHOD(SetKey);
       static NAN_METHOD(GetLength);
+      static NAN_METHOD(GetValueByKey);
+      static NAN_METHOD(ToObject);
+
+    private:
+      // positions of string keys, built on the first lookup
+      std::unordered_map<std::string, size_t> positions;
+      bool indexed;
+
+      void build_index();
+      // position of the key or the length if not found
+      size_t find(v8::Local<v8::Value>);
   };
 }
 
@@ -1,22 +1,23 @@
 #include <nan.h>
 #include "null.h"
+#include "../addon_data.h"
 
 namespace SassTypes
 {
-  Nan::Persistent<v8::Function> Null::constructor;
-  bool Null::constructor_locked = false;
-
   Null::Null() {
       value = sass_make_null();
   }
 
   Null& Null::get_singleton() {
+    // shared by all environments, each has its own JS object
     static Null singleton_instance;
     return singleton_instance;
   }
 
   v8::Local<v8::Function> Null::get_constructor() {
     Nan::EscapableHandleScope scope;
+    AddonData* data = AddonData::current();
+    Nan::Persistent<v8::Function>& constructor = data->constructor<Null>();
     v8::Local<v8::Function> conslocal;
     if (constructor.IsEmpty()) {
       v8::Local<v8::FunctionTemplate> tpl = Nan::New<v8::FunctionTemplate>(New);
@@ -27,11 +28,12 @@ namespace SassTypes
       conslocal = Nan::GetFunction(tpl).ToLocalChecked();
       constructor.Reset(conslocal);
 
-      get_singleton().js_object.Reset(Nan::NewInstance(conslocal).ToLocalChecked());
-      Nan::SetInternalFieldPointer(Nan::New(get_singleton().js_object), 0, &get_singleton());
-      Nan::Set(conslocal, Nan::New("NULL").ToLocalChecked(), Nan::New(get_singleton().js_object));
+      v8::Local<v8::Object> instance = Nan::NewInstance(conslocal).ToLocalChecked();
+      Nan::SetInternalFieldPointer(instance, 0, &get_singleton());
+      Nan::Set(conslocal, Nan::New("NULL").ToLocalChecked(), instance);
 
-      constructor_locked = true;
+      // no more instances from here on
+      data->sass_null.Reset(instance);
     } else {
       conslocal = Nan::New(constructor);
     }
@@ -40,13 +42,17 @@ namespace SassTypes
   }
 
   v8::Local<v8::Object> Null::get_js_object() {
-    return Nan::New(this->js_object);
+    AddonData* data = AddonData::current();
+    if (data->sass_null.IsEmpty()) {
+      get_constructor();
+    }
+    return Nan::New(data->sass_null);
   }
 
   NAN_METHOD(Null::New) {
 
     if (info.IsConstructCall()) {
-      if (constructor_locked) {
+      if (!AddonData::current()->sass_null.IsEmpty()) {
         return Nan::ThrowTypeError("Cannot instantiate SassNull");
       }
     }
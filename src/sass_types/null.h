@@ -12,17 +12,13 @@ namespace SassTypes
       static v8::Local<v8::Function> get_constructor();
 
       Sass_Value* get_sass_value();
+      // the instance of the current environment
       v8::Local<v8::Object> get_js_object();
 
       static NAN_METHOD(New);
 
     private:
       Null();
-
-      Nan::Persistent<v8::Object> js_object;
-
-      static Nan::Persistent<v8::Function> constructor;
-      static bool constructor_locked;
   };
 }
 
@@ -4,7 +4,7 @@
 
 namespace SassTypes
 {
-  Number::Number(Sass_Value* v) : SassValueWrapper(v) {}
+  Number::Number(Sass_Value* v, bool shared) : SassValueWrapper(v, shared) {}
 
   Sass_Value* Number::construct(const std::vector<v8::Local<v8::Value>> raw_val, Sass_Value **out) {
     double value = 0;
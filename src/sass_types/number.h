@@ -9,7 +9,7 @@ namespace SassTypes
 
   class Number : public SassValueWrapper<Number> {
     public:
-      Number(Sass_Value*);
+      Number(Sass_Value*, bool shared = false);
       static char const* get_constructor_name() { return "SassNumber"; }
       static Sass_Value* construct(const std::vector<v8::Local<v8::Value>>, Sass_Value **out);
 
@@ -6,6 +6,7 @@
 #include <nan.h>
 #include "value.h"
 #include "factory.h"
+#include "../addon_data.h"
 
 namespace SassTypes
 {
@@ -17,21 +18,15 @@ namespace SassTypes
       public:
         static char const* get_constructor_name() { return "SassValue"; }
 
-        SassValueWrapper(Sass_Value* v) : Value(v) { }
+        SassValueWrapper(Sass_Value* v, bool shared = false) : Value(v, shared) { }
         v8::Local<v8::Object> get_js_object();
 
         static v8::Local<v8::Function> get_constructor();
         static v8::Local<v8::FunctionTemplate> get_constructor_template();
         static NAN_METHOD(New);
         static Sass_Value *fail(const char *, Sass_Value **);
-
-        /* private: */
-        static Nan::Persistent<v8::Function> constructor;
     };
 
-  template <class T>
-    Nan::Persistent<v8::Function> SassValueWrapper<T>::constructor;
-
   template <class T>
     v8::Local<v8::Object> SassValueWrapper<T>::get_js_object() {
       if (this->persistent().IsEmpty()) {
@@ -55,6 +50,7 @@ namespace SassTypes
 
   template <class T>
     v8::Local<v8::Function> SassValueWrapper<T>::get_constructor() {
+      Nan::Persistent<v8::Function>& constructor = AddonData::current()->constructor<T>();
       if (constructor.IsEmpty()) {
         constructor.Reset(Nan::GetFunction(T::get_constructor_template()).ToLocalChecked());
       }
@@ -4,7 +4,7 @@
 
 namespace SassTypes
 {
-  String::String(Sass_Value* v) : SassValueWrapper(v) {}
+  String::String(Sass_Value* v, bool shared) : SassValueWrapper(v, shared) {}
 
   Sass_Value* String::construct(const std::vector<v8::Local<v8::Value>> raw_val, Sass_Value **out) {
     char const* value = "";
@@ -12,7 +12,7 @@ namespace SassTypes
     public:
       virtual v8::Local<v8::Object> get_js_object() =0;
 
-      Value() {
+      Value() : owned(true) {
 
       }
 
@@ -20,16 +20,27 @@ namespace SassTypes
         return sass_clone_value(this->value);
       }
 
+      // Takes over the item shared with a list or map once it is
+      // replaced there (false if the value has storage of its own)
+      bool adopt() {
+        if (owned) return false;
+        owned = true;
+        return true;
+      }
+
     protected:
 
       Sass_Value* value;
+      // false while the value is the item of a list or map
+      bool owned;
 
-      Value(Sass_Value* v) {
-        this->value = sass_clone_value(v);
+      Value(Sass_Value* v, bool shared = false) {
+        this->value = shared ? v : sass_clone_value(v);
+        this->owned = !shared;
       }
 
       ~Value() {
-        sass_delete_value(this->value);
+        if (owned) sass_delete_value(this->value);
       }
 
       static Sass_Value* fail(const char *reason, Sass_Value **out) {
@@ -0,0 +1,17 @@
+#include <nan.h>
+#include <string.h>
+#include <sass/base.h>
+#include "take_buffer.h"
+
+static void free_taken(char* data, void* hint) {
+  // allocated by libsass (possibly with another runtime on windows)
+  sass_free_memory(data);
+}
+
+v8::Local<v8::Object> take_buffer(char* str) {
+  return take_buffer(str, strlen(str));
+}
+
+v8::Local<v8::Object> take_buffer(char* data, size_t length) {
+  return Nan::NewBuffer(data, static_cast<uint32_t>(length), free_taken, 0).ToLocalChecked();
+}
@@ -0,0 +1,12 @@
+#ifndef TAKE_BUFFER_H
+#define TAKE_BUFFER_H
+
+#include <nan.h>
+
+// Wrap a string allocated by libsass into a Buffer without
+// copying it. The Buffer owns the string and frees it once
+// it is garbage collected.
+v8::Local<v8::Object> take_buffer(char*);
+v8::Local<v8::Object> take_buffer(char*, size_t);
+
+#endif
@@ -682,6 +682,29 @@ describe('api', function() {
         done();
       });
     });
+
+    it('should not deadlock when many async importers do async I/O', function(done) {
+      var count = 16;
+      var finished = 0;
+
+      for (var i = 0; i < count; i++) {
+        sass.render({
+          data: '@import "foo";',
+          importer: function(url, prev, done) {
+            fs.readFile(fixture('include-files/foo.scss'), 'utf8', function(err, contents) {
+              done({ contents: contents });
+            });
+          }
+        }, function(error, result) {
+          assert.equal(error, null);
+          assert(result.css.toString().length > 0);
+          if (++finished === count) {
+            done();
+          }
+        });
+      }
+    });
+
   });
 
   describe('.render(functions)', function() {
@@ -1232,6 +1255,27 @@ describe('api', function() {
         done();
       });
     });
+    it('should count the calls handed to JavaScript', function(done) {
+      var before = sass.callbackStats();
+
+      sass.render({
+        data: 'a { b: foo(); c: foo(); d: foo(); }',
+        functions: {
+          'foo()': function(done) {
+            setImmediate(function() {
+              done(new sass.types.Number(1, 'px'));
+            });
+          }
+        }
+      }, function(error) {
+        var after = sass.callbackStats();
+        assert.equal(error, null);
+        assert.equal(after.calls - before.calls, 3);
+        assert(after.roundTrips - before.roundTrips <= 3);
+        assert(after.maxLatency >= 0);
+        done();
+      });
+    });
   });
 
   describe('.render({stats: {}})', function() {
@@ -1823,6 +1867,21 @@ describe('api', function() {
       done();
     });
 
+    it('should return changes made to nested items of an argument', function(done) {
+      var result = sass.renderSync({
+        data: 'div { margin: widen((1px 2px) 3px); }',
+        functions: {
+          'widen($list)': function(list) {
+            list.getValue(0).setValue(1, new sass.types.Number(5, 'px'));
+            return list;
+          }
+        }
+      });
+
+      assert.equal(result.css.toString().trim(), 'div {\n  margin: 1px 5px 3px; }');
+      done();
+    });
+
     it('should let custom function invoke sass types constructors without the `new` keyword', function(done) {
       var result = sass.renderSync({
         data: 'div { color: foo(); }',
@@ -1987,6 +2046,50 @@ describe('api', function() {
       done();
     });
 
+    it('should provide the time spent in each phase', function(done) {
+      var phases = ['parse', 'expand', 'check_nesting', 'cssize', 'extend',
+        'remove_placeholders', 'output', 'source_map'];
+      assert.deepEqual(Object.keys(result.stats.phases), phases);
+      phases.forEach(function(phase) {
+        assert.strictEqual(typeof result.stats.phases[phase].time, 'number');
+        assert.strictEqual(typeof result.stats.phases[phase].allocations, 'number');
+      });
+      assert(result.stats.phases.parse.allocations > 0);
+      done();
+    });
+
+    it('should count custom function and importer calls', function(done) {
+      var result = sass.renderSync({
+        data: '@import "foo"; div { width: foo(); height: foo(); }',
+        importer: function() {
+          return { contents: 'a { b: c; }' };
+        },
+        functions: {
+          'foo()': function() {
+            return new sass.types.Number(42, 'px');
+          }
+        }
+      });
+
+      assert.equal(result.stats.functions.calls, 2);
+      assert.equal(result.stats.importers.calls, 1);
+      assert.strictEqual(typeof result.stats.functions.time, 'number');
+      done();
+    });
+
+    it('should count the memoized lookaheads of the parser', function(done) {
+      var result = sass.renderSync({
+        data: 'a { font-family: Arial, sans-serif; color: red; }'
+      });
+      var lookaheads = result.stats.lookaheads;
+
+      assert(lookaheads.probes > 0);
+      assert(lookaheads.hits > 0);
+      assert(lookaheads.hits <= lookaheads.probes);
+      assert(lookaheads.saved <= lookaheads.scanned);
+      done();
+    });
+
     it('should contain array with the entry if there are no import statements', function(done) {
       var expected = fixture('simple/index.scss').replace(/\\/g, '/');
 
@@ -2017,6 +2120,569 @@ describe('api', function() {
     });
   });
 
+  describe('.renderBatch(options, callback)', function() {
+    it('should compile all files and keep the input order', function(done) {
+      var files = [
+        fixture('simple/index.scss'),
+        fixture('include-path/index.scss'),
+        fixture('indent/index.sass')
+      ];
+      var seen = [];
+
+      sass.renderBatch({
+        files: files,
+        includePaths: [
+          fixture('include-path/functions'),
+          fixture('include-path/lib')
+        ],
+        concurrency: 2,
+        onResult: function(err, result, file) {
+          seen.push(file);
+        }
+      }, function(error, results) {
+        assert.equal(error, null);
+        assert.equal(results.length, 3);
+        assert.equal(results[0].css.toString().trim(), read(fixture('simple/expected.css'), 'utf8').trim().replace(/\r\n/g, '\n'));
+        assert.equal(results[1].css.toString().trim(), read(fixture('include-path/expected.css'), 'utf8').trim().replace(/\r\n/g, '\n'));
+        assert.equal(results[2].css.toString().trim(), read(fixture('indent/expected.css'), 'utf8').trim().replace(/\r\n/g, '\n'));
+        assert.equal(results[1].stats.entry, files[1]);
+        assert.deepEqual(seen.sort(), files.slice().sort());
+        done();
+      });
+    });
+
+    it('should report errors per file', function(done) {
+      sass.renderBatch({
+        files: [fixture('simple/index.scss'), fixture('does-not-exist.scss')]
+      }, function(error, results) {
+        assert.equal(error, null);
+        assert(results[0].css);
+        assert(results[1] instanceof Error);
+        assert.equal(results[1].status, 3);
+        done();
+      });
+    });
+
+    it('should call custom functions and importers of every file', function(done) {
+      var files = [
+        fixture('custom-functions/string-conversion.scss'),
+        fixture('include-files/index.scss')
+      ];
+      var imported = [];
+
+      sass.renderBatch({
+        files: files,
+        concurrency: 2,
+        functions: {
+          'foo($a)': function(a, cb) {
+            setTimeout(function() {
+              cb(new sass.types.String(a.getValue() + a.getValue()));
+            }, 1);
+          }
+        },
+        importer: function(url, prev, cb) {
+          imported.push(url);
+          setTimeout(function() {
+            cb({ contents: 'div { width: 1px; }' });
+          }, 1);
+        }
+      }, function(error, results) {
+        assert.equal(error, null);
+        assert.equal(results[0].css.toString().trim(), 'div {\n  color: barbar; }');
+        assert.equal(results[1].css.toString().trim(), 'div {\n  width: 1px; }\n\ndiv {\n  width: 1px; }');
+        assert.deepEqual(imported.sort(), ['bar', 'foo']);
+        done();
+      });
+    });
+
+    it('should read the timeout as an unsigned integer', function(done) {
+      sass.renderBatch({
+        files: [fixture('simple/index.scss')],
+        timeout: 4294967295
+      }, function(error, results) {
+        assert.equal(error, null);
+        assert(results[0].css);
+        done();
+      });
+    });
+  });
+
+  describe('.createCompiler(options)', function() {
+    it('should compile many inputs with the same options', function(done) {
+      var compiler = sass.createCompiler({
+        outputStyle: 'compressed',
+        functions: {
+          'double($a)': function(a) {
+            return new sass.types.Number(a.getValue() * 2);
+          }
+        }
+      });
+
+      assert.equal(compiler.renderSync({ data: 'a { b: double(1) }' }).css.toString().trim(), 'a{b:2}');
+      assert.equal(compiler.renderSync({ data: 'a { b: double(2) }' }).css.toString().trim(), 'a{b:4}');
+
+      compiler.render({ data: 'a { b: double(3) }' }, function(error, result) {
+        assert.equal(error, null);
+        assert.equal(result.css.toString().trim(), 'a{b:6}');
+
+        compiler.render({ file: fixture('simple/index.scss') }, function(error, result) {
+          assert.equal(error, null);
+          assert.equal(result.stats.entry, fixture('simple/index.scss'));
+          done();
+        });
+      });
+    });
+
+    it('should report errors per render', function(done) {
+      var compiler = sass.createCompiler({});
+
+      assert.throws(function() {
+        compiler.renderSync({ data: 'a {' });
+      });
+
+      compiler.render({ data: 'a {' }, function(error) {
+        assert(error instanceof Error);
+        assert.equal(error.status, 1);
+        done();
+      });
+    });
+  });
+
+  describe('.renderSync({sheetCache: true})', function() {
+    beforeEach(function() {
+      sass.invalidateSheetCache();
+    });
+
+    it('should reuse parsed files and produce the same output', function(done) {
+      var options = {
+        file: fixture('include-path/index.scss'),
+        includePaths: [
+          fixture('include-path/functions'),
+          fixture('include-path/lib')
+        ],
+        sheetCache: true
+      };
+      var expected = read(fixture('include-path/expected.css'), 'utf8').trim();
+      var first = sass.renderSync(options);
+      var hits = sass.sheetCacheStats().hits;
+      var second = sass.renderSync(options);
+
+      assert.equal(first.css.toString().trim(), expected.replace(/\r\n/g, '\n'));
+      assert.equal(second.css.toString(), first.css.toString());
+      assert.deepEqual(second.stats.includedFiles, first.stats.includedFiles);
+      assert(sass.sheetCacheStats().hits > hits);
+      done();
+    });
+
+    it('should drop files on invalidate', function(done) {
+      sass.renderSync({ file: fixture('simple/index.scss'), sheetCache: true });
+      assert.equal(sass.sheetCacheStats().size, 1);
+      sass.invalidateSheetCache(fixture('simple/index.scss'));
+      assert.equal(sass.sheetCacheStats().size, 0);
+      done();
+    });
+  });
+
+  describe('.renderSync({fileCache: true})', function() {
+    beforeEach(function() {
+      sass.invalidateFileCache();
+    });
+
+    it('should resolve imports from memory and produce the same output', function(done) {
+      var options = {
+        file: fixture('include-path/index.scss'),
+        includePaths: [
+          fixture('include-path/functions'),
+          fixture('include-path/lib')
+        ],
+        fileCache: true
+      };
+      var expected = read(fixture('include-path/expected.css'), 'utf8').trim();
+      var first = sass.renderSync(options);
+      var stats = sass.fileCacheStats();
+      var second = sass.renderSync(options);
+
+      assert.equal(first.css.toString().trim(), expected.replace(/\r\n/g, '\n'));
+      assert.equal(second.css.toString(), first.css.toString());
+      assert(sass.fileCacheStats().hits > stats.hits);
+      assert.equal(sass.fileCacheStats().misses, stats.misses);
+      done();
+    });
+
+    it('should find added files after invalidate', function(done) {
+      var src = fixture('simple/_added.scss');
+      var options = {
+        data: '@import "added";',
+        includePaths: [fixture('simple')],
+        fileCache: true
+      };
+
+      assert.throws(function() {
+        sass.renderSync(options);
+      }, /File to import not found or unreadable: added/);
+
+      fs.writeFileSync(src, 'div { color: red; }');
+      try {
+        sass.invalidateFileCache(src);
+        assert.equal(sass.renderSync(options).css.toString().trim(), 'div {\n  color: red; }');
+      } finally {
+        fs.unlinkSync(src);
+      }
+      done();
+    });
+  });
+
+  describe('.renderSync({functionCache: true})', function() {
+    beforeEach(function() {
+      sass.clearFunctionCache();
+    });
+
+    it('should call pure functions once per distinct arguments', function(done) {
+      var calls = 0;
+      var double = function(n) {
+        calls++;
+        return new sass.types.Number(n.getValue() * 2, n.getUnit());
+      };
+      double.pure = true;
+
+      var result = sass.renderSync({
+        data: 'div { a: double(1px); b: double(1px); c: double(2px); }',
+        functions: { 'double($n)': double }
+      });
+
+      assert.equal(result.css.toString().trim(), 'div {\n  a: 2px;\n  b: 2px;\n  c: 4px; }');
+      assert.equal(calls, 2);
+      done();
+    });
+
+    it('should share results between renders', function(done) {
+      var calls = 0;
+      var double = function(n) {
+        calls++;
+        return new sass.types.Number(n.getValue() * 2, n.getUnit());
+      };
+      double.pure = true;
+      var options = {
+        data: 'div { a: double(1px); }',
+        functions: { 'double($n)': double },
+        functionCache: true
+      };
+
+      var first = sass.renderSync(options);
+      var second = sass.renderSync(options);
+
+      assert.equal(second.css.toString(), first.css.toString());
+      assert.equal(calls, 1);
+      assert.equal(sass.functionCacheStats().size, 1);
+      assert(sass.functionCacheStats().hits > 0);
+
+      sass.clearFunctionCache();
+      sass.renderSync(options);
+      assert.equal(calls, 2);
+      done();
+    });
+
+    it('should keep the results of compilers apart', function(done) {
+      var make = function(factor) {
+        var fn = function(n) {
+          return new sass.types.Number(n.getValue() * factor, n.getUnit());
+        };
+        fn.pure = true;
+        return sass.createCompiler({
+          functions: { 'scale($n)': fn },
+          functionCache: true
+        });
+      };
+      var double = make(2);
+      var triple = make(3);
+
+      assert.equal(double.renderSync({ data: 'a { b: scale(1px); }' }).css.toString().trim(), 'a {\n  b: 2px; }');
+      assert.equal(triple.renderSync({ data: 'a { b: scale(1px); }' }).css.toString().trim(), 'a {\n  b: 3px; }');
+      assert.equal(sass.functionCacheStats().size, 0);
+      done();
+    });
+  });
+
+  describe('.render() in worker threads', function() {
+    var workerThreads;
+
+    before(function() {
+      try {
+        workerThreads = require('worker_threads');
+      } catch (e) {
+        this.skip();
+      }
+    });
+
+    it('should render in parallel workers with custom functions', function(done) {
+      var source = [
+        'var workerThreads = require("worker_threads");',
+        'var sass = require(' + JSON.stringify(sassPath) + ');',
+        'sass.render({',
+        '  data: "div { width: double(21px); color: if(true, red, blue); }",',
+        '  functions: {',
+        '    "double($n)": function(n, done) {',
+        '      setImmediate(function() {',
+        '        done(new sass.types.Number(n.getValue() * 2, n.getUnit()));',
+        '      });',
+        '    }',
+        '  }',
+        '}, function(error, result) {',
+        '  workerThreads.parentPort.postMessage(error ? error.message : result.css.toString());',
+        '});'
+      ].join('\n');
+      var expected = 'div {\n  width: 42px;\n  color: red; }';
+      var pending = 3;
+
+      for (var i = 0; i < 3; i++) {
+        new workerThreads.Worker(source, { eval: true }).on('message', function(css) {
+          assert.equal(css.trim(), expected);
+          if (--pending === 0) {
+            done();
+          }
+        });
+      }
+    });
+
+    it('should use compilers and batches in workers', function(done) {
+      var source = [
+        'var workerThreads = require("worker_threads");',
+        'var sass = require(' + JSON.stringify(sassPath) + ');',
+        'var compiler = sass.createCompiler({',
+        '  functions: {',
+        '    "double($n)": function(n) {',
+        '      return new sass.types.Number(n.getValue() * 2, n.getUnit());',
+        '    }',
+        '  }',
+        '});',
+        'var css = compiler.renderSync({ data: "div { width: double(21px); }" }).css.toString();',
+        'sass.renderBatch({',
+        '  files: [' + JSON.stringify(fixture('simple/index.scss')) + ']',
+        '}, function(error, results) {',
+        '  workerThreads.parentPort.postMessage([css, results[0].css.toString()]);',
+        '});'
+      ].join('\n');
+      var expected = read(fixture('simple/expected.css'), 'utf8').trim().replace(/\r\n/g, '\n');
+      var pending = 2;
+
+      for (var i = 0; i < 2; i++) {
+        new workerThreads.Worker(source, { eval: true }).on('message', function(css) {
+          assert.equal(css[0].trim(), 'div {\n  width: 42px; }');
+          assert.equal(css[1].trim(), expected);
+          if (--pending === 0) {
+            done();
+          }
+        });
+      }
+    });
+
+    it('should not crash when a worker exits during a render', function(done) {
+      var source = [
+        'var workerThreads = require("worker_threads");',
+        'var sass = require(' + JSON.stringify(sassPath) + ');',
+        'sass.render({',
+        '  data: "div { width: never(1px); }",',
+        '  functions: {',
+        '    "never($n)": function() {',
+        '      workerThreads.parentPort.postMessage("called");',
+        '    }',
+        '  }',
+        '}, function() {});'
+      ].join('\n');
+      var worker = new workerThreads.Worker(source, { eval: true });
+
+      worker.on('message', function() {
+        worker.terminate();
+      });
+      worker.on('exit', function() {
+        done();
+      });
+    });
+
+    it('should stop pending renders and batches when a worker exits', function(done) {
+      var source = [
+        'var workerThreads = require("worker_threads");',
+        'var sass = require(' + JSON.stringify(sassPath) + ');',
+        'var endless = "$i: 0; @while true { $i: $i + 1; }";',
+        'sass.render({ data: endless }, function() {});',
+        'sass.render({ data: endless }, function() {});',
+        'sass.renderBatch({',
+        '  files: [' + JSON.stringify(fixture('include-files/index.scss')) + '],',
+        '  concurrency: 1',
+        '}, function() {});',
+        'workerThreads.parentPort.postMessage("started");'
+      ].join('\n');
+      var worker = new workerThreads.Worker(source, { eval: true });
+
+      worker.on('message', function() {
+        setTimeout(function() {
+          worker.terminate();
+        }, 50);
+      });
+      worker.on('exit', function() {
+        done();
+      });
+    });
+
+    it('should not crash when a worker exits during a batch importer', function(done) {
+      var source = [
+        'var workerThreads = require("worker_threads");',
+        'var sass = require(' + JSON.stringify(sassPath) + ');',
+        'sass.renderBatch({',
+        '  files: [' + JSON.stringify(fixture('include-files/index.scss')) + '],',
+        '  importer: function() {',
+        '    workerThreads.parentPort.postMessage("called");',
+        '  }',
+        '}, function() {});'
+      ].join('\n');
+      var worker = new workerThreads.Worker(source, { eval: true });
+
+      worker.on('message', function() {
+        worker.terminate();
+      });
+      worker.on('exit', function() {
+        done();
+      });
+    });
+  });
+
+  describe('.renderSync({importThreads: 4})', function() {
+    it('should compile imports in the same order as a serial render', function(done) {
+      var expected = read(fixture('depth-first/expected.css'), 'utf8').trim();
+      var serial = sass.renderSync({ file: fixture('depth-first/index.scss') });
+      var result = sass.renderSync({
+        file: fixture('depth-first/index.scss'),
+        importThreads: 4
+      });
+
+      assert.equal(result.css.toString().trim(), expected.replace(/\r\n/g, '\n'));
+      assert.deepEqual(result.stats.includedFiles, serial.stats.includedFiles);
+      done();
+    });
+
+    it('should report unresolved imports', function(done) {
+      assert.throws(function() {
+        sass.renderSync({ file: fixture('include-path/index.scss'), importThreads: 4 });
+      }, /File to import not found or unreadable: vars/);
+      done();
+    });
+  });
+
+  describe('.renderSync({data: @extend of attribute selectors})', function() {
+    it('should extend attribute selectors quoted like the target', function(done) {
+      var expected = read(fixture('extend-attributes/expected.css'), 'utf8').trim();
+      var result = sass.renderSync({ file: fixture('extend-attributes/index.scss') });
+
+      assert.equal(result.css.toString().trim(), expected.replace(/\r\n/g, '\n'));
+      done();
+    });
+
+    it('should not find attribute selectors quoted unlike the target', function(done) {
+      assert.throws(function() {
+        sass.renderSync({ data: 'a[x=y] { p: v; }\n.c { @extend [x="y"]; }' });
+      }, /The selector "\[x="y"\]" was not found/);
+      done();
+    });
+  });
+
+  describe('.render({timeout: 100})', function() {
+    var runaway = '$i: 0; .a { @while $i < 1 { $x: $i; } }';
+
+    it('should stop a runaway loop', function(done) {
+      sass.render({ data: runaway, timeout: 100 }, function(error, result) {
+        assert(!result);
+        assert.equal(error.status, 1);
+        assert.ok(/compilation timed out after 100ms/.test(error.message));
+        done();
+      });
+    });
+
+    it('should stop a runaway loop of renderSync', function(done) {
+      assert.throws(function() {
+        sass.renderSync({ data: runaway, timeout: 100 });
+      }, /compilation timed out after 100ms/);
+      done();
+    });
+
+    it('should not change renders finishing in time', function(done) {
+      var data = '@for $i from 1 through 3 { .a#{$i} { width: $i * 1px; } }';
+      var expected = sass.renderSync({ data: data }).css.toString();
+      var result = sass.renderSync({ data: data, timeout: 10000 });
+
+      assert.equal(result.css.toString(), expected);
+      done();
+    });
+  });
+
+  describe('.render({outputStream: stream})', function() {
+    var src = '@for $i from 1 through 5000 { .a#{$i} { width: $i * 1px; } }';
+
+    it('should write the same css in chunks', function(done) {
+      var chunks = [];
+      var expected = sass.renderSync({ data: src }).css.toString();
+
+      sass.render({
+        data: src,
+        outputStream: { write: function(chunk) { chunks.push(chunk); } }
+      }, function(error, result) {
+        assert.equal(error, null);
+        assert.equal(result.css.length, 0);
+        assert(chunks.length > 1);
+        assert.equal(Buffer.concat(chunks).toString(), expected);
+        done();
+      });
+    });
+
+    it('should write chunks in renderSync', function(done) {
+      var chunks = [];
+      var result = sass.renderSync({
+        data: src,
+        outputStyle: 'compressed',
+        outputStream: { write: function(chunk) { chunks.push(chunk); } }
+      });
+
+      assert.equal(result.css.length, 0);
+      assert.equal(Buffer.concat(chunks).toString(), sass.renderSync({ data: src, outputStyle: 'compressed' }).css.toString());
+      done();
+    });
+  });
+
+  describe('.renderSync({mmapSources: true})', function() {
+    var src = fixture('simple/big.scss');
+
+    before(function() {
+      var rules = [];
+      for (var i = 0; i < 3000; i++) {
+        rules.push('.rule-' + i + ' { width: ' + i + 'px + 1px; }');
+      }
+      fs.writeFileSync(src, rules.join('\n'));
+    });
+
+    after(function() {
+      fs.unlinkSync(src);
+    });
+
+    it('should compile big files to the same output', function(done) {
+      var expected = sass.renderSync({ file: src }).css.toString();
+      var result = sass.renderSync({ file: src, mmapSources: true });
+
+      assert.equal(result.css.toString(), expected);
+      done();
+    });
+
+    it('should compile imported big files', function(done) {
+      var expected = sass.renderSync({ data: '@import "big";', includePaths: [fixture('simple')] }).css.toString();
+      var result = sass.renderSync({
+        data: '@import "big";',
+        includePaths: [fixture('simple')],
+        mmapSources: true
+      });
+
+      assert.equal(result.css.toString(), expected);
+      done();
+    });
+  });
+
   describe('.info', function() {
     var package = require('../package.json'),
       info = sass.info;
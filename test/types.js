@@ -398,6 +398,54 @@ describe('sass.types', function() {
       });
     });
 
+    it('returns the same wrapper until the value is replaced', function() {
+      var a = new sass.types.List(2);
+      a.setValue(0, new sass.types.String('a'));
+      a.setValue(1, new sass.types.Number(1, 'px'));
+
+      var first = a.getValue(0);
+      assert.strictEqual(a.getValue(0), first);
+
+      a.setValue(0, new sass.types.String('b'));
+      assert.notStrictEqual(a.getValue(0), first);
+      assert.equal(a.getValue(0).getValue(), 'b');
+    });
+
+    it('shows changes made through the wrapper of a nested item', function() {
+      var inner = new sass.types.List(2, false);
+      inner.setValue(0, new sass.types.Number(1, 'px'));
+      inner.setValue(1, new sass.types.Number(2, 'px'));
+      var outer = new sass.types.List(2, false);
+      outer.setValue(0, inner);
+      outer.setValue(1, new sass.types.Number(3, 'px'));
+
+      outer.getValue(0).setValue(1, new sass.types.Number(5, 'px'));
+      outer.getValue(0).getValue(0).setValue(4);
+
+      assert.equal(outer.getValue(0).getValue(1).getValue(), 5);
+      assert.deepEqual(outer.toArray(), [['4px', '5px'], '3px']);
+
+      var copy = new sass.types.List(1);
+      copy.setValue(0, outer);
+      assert.deepEqual(copy.getValue(0).toArray(), [['4px', '5px'], '3px']);
+
+      // a replaced item stays usable through its wrapper
+      var nested = outer.getValue(0);
+      outer.setValue(0, new sass.types.Number(0));
+      nested.getValue(0).setValue(6);
+      assert.deepEqual(nested.toArray(), ['6px', '5px']);
+      assert.deepEqual(outer.toArray(), [0, '3px']);
+    });
+
+    it('supports toArray', function() {
+      var a = new sass.types.List(3);
+      a.setValue(0, new sass.types.String('a'));
+      a.setValue(1, new sass.types.Number(1, 'px'));
+      a.setValue(2, new sass.types.Number(2));
+
+      assert.deepEqual(a.toArray(), ['a', '1px', 2]);
+    });
+
     // TODO: more complex set/get value scenarios
   });
 
@@ -453,6 +501,50 @@ describe('sass.types', function() {
       y.setValue(0, omg);
       console.log(y.getValue(0));
     });
+
+    it('supports getValueByKey', function() {
+      var y = new sass.types.Map(3);
+      y.setKey(0, new sass.types.String('a'));
+      y.setValue(0, new sass.types.Number(1));
+      y.setKey(1, new sass.types.String('b'));
+      y.setValue(1, new sass.types.Number(2));
+      y.setKey(2, new sass.types.Number(3));
+      y.setValue(2, new sass.types.Number(4));
+
+      assert.equal(y.getValueByKey('b').getValue(), 2);
+      assert.equal(y.getValueByKey(new sass.types.String('a')).getValue(), 1);
+      assert.equal(y.getValueByKey(new sass.types.Number(3)).getValue(), 4);
+      assert.strictEqual(y.getValueByKey('c'), undefined);
+      assert.strictEqual(y.getValueByKey('b'), y.getValue(1));
+
+      y.setKey(1, new sass.types.String('c'));
+      assert.strictEqual(y.getValueByKey('b'), undefined);
+      assert.equal(y.getValueByKey('c').getValue(), 2);
+    });
+
+    it('supports toObject', function() {
+      var y = new sass.types.Map(2);
+      var list = new sass.types.List(1);
+      list.setValue(0, sass.types.Boolean.TRUE);
+      y.setKey(0, new sass.types.String('a'));
+      y.setValue(0, list);
+      y.setKey(1, new sass.types.String('b'));
+      y.setValue(1, sass.types.Null.NULL);
+
+      assert.deepEqual(y.toObject(), { a: [true], b: null });
+    });
+
+    it('shows changes made through the wrapper of a value', function() {
+      var y = new sass.types.Map(1);
+      var list = new sass.types.List(1);
+      list.setValue(0, new sass.types.Number(1));
+      y.setKey(0, new sass.types.String('a'));
+      y.setValue(0, list);
+
+      y.getValueByKey('a').setValue(0, new sass.types.String('b'));
+      assert.equal(y.getValue(0).getValue(0).getValue(), 'b');
+      assert.deepEqual(y.toObject(), { a: ['b'] });
+    });
   });
 
   describe('Null', function() {
@@ -2,6 +2,7 @@ var assert = require('assert'),
   fs = require('fs-extra'),
   path = require('path'),
   temp = require('unique-temp-dir'),
+  sass = require('../lib'),
   watcher = require('../lib/watcher');
 
 describe('watcher', function() {
@@ -500,4 +501,105 @@ describe('watcher', function() {
       });
     });
   });
+
+  describe('entry points', function() {
+    it('should only list the files of the directory that are not partials', function() {
+      fs.writeFileSync(path.join(sibling, 'vendor.scss'), '.vendor { color: black; }');
+      fs.writeFileSync(path.join(main, 'two.scss'), '@import "vendor";');
+      watcher.reset({
+        directory: main,
+        includePath: [main, sibling]
+      });
+      assert.deepEqual(watcher.entries().sort(), [
+        path.join(main, 'one.scss'),
+        path.join(main, 'three.scss'),
+        path.join(main, 'two.scss'),
+      ]);
+    });
+
+    it('should only list the source file', function() {
+      watcher.reset({
+        src: path.join(main, 'one.scss'),
+        includePath: [main]
+      });
+      assert.deepEqual(watcher.entries(), [
+        path.join(main, 'one.scss'),
+      ]);
+    });
+  });
+
+  describe('with session', function() {
+    beforeEach(function() {
+      watcher.reset({
+        directory: main,
+        includePath: [main]
+      });
+      ['one.scss', 'two.scss'].forEach(function(file) {
+        sass.renderSync({
+          file: path.join(main, file),
+          includePaths: [main],
+          sheetCache: true
+        });
+      });
+      watcher.useSession(sass);
+    });
+
+    afterEach(function() {
+      watcher.useSession(null);
+    });
+
+    it('should record the entry points of a changed partial as changed', function() {
+      var file = path.join(main, 'partials', '_three.scss');
+      var files = watcher.changed(file);
+      assert.deepEqual(files.changed, [
+        path.join(main, 'one.scss'),
+      ]);
+    });
+
+    it('should not parse the imports of a changed partial', function() {
+      var file = path.join(main, 'partials', '_one.scss');
+      var files = watcher.changed(file);
+      assert.deepEqual(files.added, []);
+    });
+
+    it('should take new imports from the session once the entry compiled again', function() {
+      var file = path.join(main, 'partials', '_one.scss');
+      var entry = path.join(main, 'one.scss');
+      fs.writeFileSync(file, '@import "partials/two";');
+      assert.deepEqual(watcher.changed(file).changed, [entry]);
+      sass.renderSync({
+        file: entry,
+        includePaths: [main],
+        sheetCache: true
+      });
+      assert.deepEqual(watcher.imports(entry).sort(), [
+        path.join(main, 'partials', '_one.scss'),
+        path.join(main, 'partials', '_three.scss'),
+        path.join(main, 'partials', '_two.scss'),
+      ]);
+    });
+
+    it('should not record entry points outside of the directory', function() {
+      sass.renderSync({
+        file: path.join(sibling, 'three.scss'),
+        includePaths: [sibling],
+        sheetCache: true
+      });
+      var file = path.join(main, 'partials', '_three.scss');
+      var files = watcher.changed(file);
+      assert.deepEqual(files.changed, [
+        path.join(main, 'one.scss'),
+      ]);
+    });
+
+    it('should record a removed partial as removed', function() {
+      var file = path.join(main, 'partials', '_one.scss');
+      var files = watcher.removed(file);
+      assert.deepEqual(files, {
+        added: [],
+        changed: [path.join(main, 'one.scss')],
+        removed: [file],
+      });
+    });
+  });
 });